@@ -79,15 +79,18 @@ struct LilvInstanceImpl;
    @{
 */
 
-typedef struct LilvPluginImpl      LilvPlugin;      /**< LV2 Plugin. */
-typedef struct LilvPluginClassImpl LilvPluginClass; /**< Plugin Class. */
-typedef struct LilvPortImpl        LilvPort;        /**< Port. */
-typedef struct LilvScalePointImpl  LilvScalePoint;  /**< Scale Point. */
-typedef struct LilvUIImpl          LilvUI;          /**< Plugin UI. */
-typedef struct LilvNodeImpl        LilvNode;        /**< Typed Value. */
-typedef struct LilvWorldImpl       LilvWorld;       /**< Lilv World. */
-typedef struct LilvInstanceImpl    LilvInstance;    /**< Plugin instance. */
-typedef struct LilvStateImpl       LilvState;       /**< Plugin state. */
+typedef struct LilvPluginImpl       LilvPlugin;       /**< LV2 Plugin. */
+typedef struct LilvPluginClassImpl  LilvPluginClass;  /**< Plugin Class. */
+typedef struct LilvPortImpl         LilvPort;         /**< Port. */
+typedef struct LilvScalePointImpl   LilvScalePoint;   /**< Scale Point. */
+typedef struct LilvUIImpl           LilvUI;           /**< Plugin UI. */
+typedef struct LilvNodeImpl         LilvNode;         /**< Typed Value. */
+typedef struct LilvWorldImpl        LilvWorld;        /**< Lilv World. */
+typedef struct LilvInstanceImpl     LilvInstance;     /**< Plugin instance. */
+typedef struct LilvInstancePoolImpl LilvInstancePool; /**< Instance pool. */
+typedef struct LilvStateImpl        LilvState;        /**< Plugin state. */
+typedef struct LilvFeatureSetImpl   LilvFeatureSet;   /**< Set of features. */
+typedef struct LilvGraphImpl        LilvGraph;        /**< Plugin graph. */
 
 typedef void LilvIter;          /**< Collection iterator */
 typedef void LilvPluginClasses; /**< A set of #LilvPluginClass. */
@@ -569,6 +572,16 @@ LILV_API
 bool
 lilv_plugins_is_end(const LilvPlugins* collection, LilvIter* i);
 
+/**
+   Free a plugin collection returned by lilv_plugin_class_get_plugins().
+
+   The plugins themselves are owned by the world and are not freed.  This must
+   not be called on the collection returned by lilv_world_get_all_plugins().
+*/
+LILV_API
+void
+lilv_plugins_free(LilvPlugins* collection);
+
 /**
    Get a plugin from `plugins` by URI.
 
@@ -628,6 +641,66 @@ lilv_world_new(void);
 */
 #define LILV_OPTION_LV2_PATH "http://drobilla.net/ns/lilv#lv2-path"
 
+/**
+   Set the number of threads used to discover bundles.
+
+   If this is greater than 1, lilv_world_load_all() parses bundle manifests in
+   parallel with the given number of threads.  The parsed data is merged into
+   the world in LV2_PATH order, so the result is the same as serial loading:
+   the first version of a plugin found in LV2_PATH is used, unless a later
+   bundle contains a newer version.  This also sets the number of threads
+   used by lilv_world_load_all_plugin_data().  The default is 1 (serial
+   loading).
+*/
+#define LILV_OPTION_DISCOVERY_THREADS \
+  "http://drobilla.net/ns/lilv#discovery-threads"
+
+/**
+   Set a directory to cache parsed data files in.
+
+   If this is set, lilv stores the statements parsed from each data file in a
+   compact binary form in the given directory, and loads them from there
+   instead of parsing the file again if its size and modification time have
+   not changed.  The directory is created if necessary.  By default, nothing
+   is cached.
+*/
+#define LILV_OPTION_CACHE_DIR "http://drobilla.net/ns/lilv#cache-dir"
+
+/**
+   Set the number of unused plugin libraries to keep open.
+
+   Normally, a plugin library is closed as soon as its last instance is freed,
+   so instantiating one of its plugins again must load it again.  If this is
+   greater than zero, up to this many unused libraries are kept open, and the
+   least recently used ones are closed when there are more.  Instantiating a
+   plugin from a library that is still open does not use the dynamic loader
+   at all.  Kept libraries can be closed early with
+   lilv_world_trim_libraries().  The default is 0 (close immediately).
+*/
+#define LILV_OPTION_KEEP_LIBRARIES \
+  "http://drobilla.net/ns/lilv#keep-libraries"
+
+/**
+   Enable/disable statistics.
+
+   If this is true, the world counts the work done to load and query data,
+   which can be retrieved with lilv_world_get_stats().  Statistics are
+   disabled by default.
+*/
+#define LILV_OPTION_STATS "http://drobilla.net/ns/lilv#stats"
+
+/**
+   Set a file to write trace events to.
+
+   If lilv was built with trace support, the time spent in functions that load
+   bundles, plugins, libraries, and state is written to this file in the
+   Chrome trace event format, which can be viewed in a browser or Perfetto.
+   The file is finished when the world is destroyed.  The environment
+   variable LILV_TRACE_FILE may be used to set a default.  By default, no
+   trace is written.
+*/
+#define LILV_OPTION_TRACE_FILE "http://drobilla.net/ns/lilv#trace-file"
+
 /**
    Set an option for `world`.
 
@@ -636,6 +709,11 @@ lilv_world_new(void);
    - #LILV_OPTION_FILTER_LANG
    - #LILV_OPTION_DYN_MANIFEST
    - #LILV_OPTION_LV2_PATH
+   - #LILV_OPTION_DISCOVERY_THREADS
+   - #LILV_OPTION_CACHE_DIR
+   - #LILV_OPTION_KEEP_LIBRARIES
+   - #LILV_OPTION_STATS
+   - #LILV_OPTION_TRACE_FILE
 */
 LILV_API
 void
@@ -663,11 +741,193 @@ lilv_world_free(LilvWorld* world);
    Hosts should use this function rather than explicitly load bundles, except
    in special circumstances such as development utilities, or hosts that ship
    with special plugin bundles which are installed to a known location.
+
+   Specifications and plugin classes are not loaded immediately, but the first
+   time they are needed, for example by lilv_world_get_plugin_classes(),
+   lilv_plugin_get_class(), or a query on the world.
 */
 LILV_API
 void
 lilv_world_load_all(LilvWorld* world);
 
+/**
+   Counts of the work done by a world, if #LILV_OPTION_STATS is enabled.
+
+   Queries on a frozen world are counted under the same lock that protects
+   the model, so counts are exact when querying from several threads.
+*/
+typedef struct {
+  uint64_t n_files_parsed;      ///< Data files parsed
+  uint64_t n_files_cached;      ///< Data files loaded from the cache
+  uint64_t n_bytes_read;        ///< Total size of all loaded data files
+  uint64_t read_time_us;        ///< Time spent loading data files
+  uint64_t n_triples;           ///< Statements currently in the model
+  uint64_t n_bundles_loaded;    ///< Bundles loaded, including reloads
+  uint64_t n_version_conflicts; ///< Plugins found in several bundles
+  uint64_t n_plugin_loads;      ///< Plugins whose data has been loaded
+  uint64_t n_port_tables;       ///< Plugin port tables built
+  uint64_t n_queries;           ///< Searches of the model
+} LilvWorldStats;
+
+/**
+   Return the statistics for `world`.
+
+   All counts except `n_triples` are zero unless #LILV_OPTION_STATS was
+   enabled before loading.
+*/
+LILV_API
+LilvWorldStats
+lilv_world_get_stats(const LilvWorld* world);
+
+/**
+   Print the statistics for `world` to `stream`.
+
+   This prints the counts from lilv_world_get_stats(), followed by the number
+   of statements in each graph of the model, which shows how much data each
+   bundle and file contributes.
+*/
+LILV_API
+void
+lilv_world_print_stats(const LilvWorld* world, FILE* stream);
+
+/**
+   Load the data files of every plugin.
+
+   Plugin data is normally loaded the first time a plugin is accessed.  This
+   loads it for all plugins at once, parsing files in parallel if
+   #LILV_OPTION_DISCOVERY_THREADS is greater than 1.  Files shared by several
+   plugins are only loaded once.
+
+   This modifies the world, so it must not be called concurrently with any
+   other use of it, but hosts may call it from a background thread after
+   lilv_world_load_all() to avoid a delay when plugins are first accessed.
+*/
+LILV_API
+void
+lilv_world_load_all_plugin_data(LilvWorld* world);
+
+/**
+   Close all plugin libraries that are only open to be kept alive.
+
+   This closes the unused libraries kept open by #LILV_OPTION_KEEP_LIBRARIES
+   or lilv_world_preload_libraries(), for example to release memory.
+   Libraries with instances are not affected.
+
+   @return The number of libraries that were closed.
+*/
+LILV_API
+unsigned
+lilv_world_trim_libraries(LilvWorld* world);
+
+/**
+   Open the libraries of several plugins in advance.
+
+   The first instantiation of a plugin normally blocks while its library is
+   loaded, which can be slow for large libraries.  This loads the libraries
+   used by `plugins` with up to `n_threads` threads, so later calls to
+   lilv_plugin_instantiate() find them already open.  Plugins that share a
+   library only load it once.
+
+   Preloaded libraries stay open until lilv_world_trim_libraries() is called
+   or the world is freed, regardless of #LILV_OPTION_KEEP_LIBRARIES.
+
+   This loads plugin data and modifies the world, so it must not be called
+   concurrently with any other use of it.
+
+   @param world The world.
+   @param plugins Array of plugins whose libraries should be opened.
+   @param n_plugins Number of elements in `plugins`.
+   @param features Features passed to any `lv2_lib_descriptor` function.
+   @param n_threads Maximum number of threads to open libraries with.
+   @return The number of libraries that were newly preloaded.
+*/
+LILV_API
+unsigned
+lilv_world_preload_libraries(LilvWorld*                world,
+                             const LilvPlugin* const*  plugins,
+                             size_t                    n_plugins,
+                             const LV2_Feature* const* features,
+                             unsigned                  n_threads);
+
+/**
+   Finish loading everything needed for queries, so they can run in parallel.
+
+   This loads any pending specifications and plugin classes, along with the
+   data, ports, class, and library URI of every plugin.  After this, the
+   functions that query the world, plugins, ports, UIs, and nodes may be
+   called from several threads at once, and nodes and feature sets may be
+   created and freed concurrently.
+
+   Functions that modify the world, such as loading or unloading bundles,
+   setting options, or loading state, must still not be called concurrently
+   with anything else.  Call this function again after loading more data.
+*/
+LILV_API
+void
+lilv_world_freeze(LilvWorld* world);
+
+/**
+   Rescan LV2_PATH and reload any bundles that have changed.
+
+   This finds bundles in the same way as lilv_world_load_all(), but only
+   touches those that have changed since they were loaded.  New bundles are
+   loaded, bundles that have been removed are unloaded, and bundles where the
+   modification time or size of the directory or any file directly in it has
+   changed are unloaded and loaded again.  Checking unchanged bundles only
+   requires a stat() of each file, so this is cheap enough to call whenever
+   the host wants to notice newly installed plugins.
+
+   As with lilv_world_unload_bundle(), plugins from unloaded bundles are
+   removed from lilv_world_get_all_plugins() but remain valid.
+
+   @return The number of bundles that were loaded, reloaded, or unloaded.
+*/
+LILV_API
+int
+lilv_world_rescan(LilvWorld* world);
+
+/**
+   Start watching LV2_PATH for changes to bundles.
+
+   This watches every directory in LV2_PATH and every bundle in them, so that
+   bundles which are installed, changed, or removed can be picked up without
+   polling.  The world itself is not modified until the host calls
+   lilv_world_process_changes(), so the host can choose a safe time to apply
+   changes.
+
+   Watching is currently only supported on Linux (with inotify).
+
+   @return A file descriptor which becomes readable when there are new
+   changes, which the host may poll or add to its own event loop, or -1 if
+   watching is not supported or failed.  The descriptor is owned by the world
+   and is closed by lilv_world_free().
+*/
+LILV_API
+int
+lilv_world_watch(LilvWorld* world);
+
+/**
+   Apply changes to watched bundles.
+
+   Changes are applied to a bundle only after it has been left alone for a
+   short time (a quarter of a second), so a bundle is not loaded while it is
+   still being written.  Changed bundles are reloaded with
+   lilv_world_unload_bundle() and lilv_world_load_bundle(), so plugins from
+   changed or removed bundles remain valid as described there.
+
+   Since changes are delayed, hosts should call this both when the descriptor
+   returned by lilv_world_watch() is readable, and periodically, for example
+   from a timer in their main loop.  Calling this when nothing has changed is
+   cheap and does not access the file system.  If the system dropped change
+   events because too many happened at once, this falls back to
+   lilv_world_rescan().
+
+   @return The number of bundles that were loaded, reloaded, or unloaded.
+*/
+LILV_API
+int
+lilv_world_process_changes(LilvWorld* world);
+
 /**
    Load a specific bundle.
 
@@ -690,7 +950,9 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri);
 
    This is for hosts that explicitly load specific bundles, its use is not
    necessary when using lilv_world_load_all().  This function parses the
-   specifications and adds them to the model.
+   specifications and adds them to the model.  This may be used after
+   lilv_world_load_all() to load everything up front, rather than the first
+   time it is needed.
 */
 LILV_API
 void
@@ -778,6 +1040,24 @@ LILV_API
 const LilvPlugins*
 lilv_world_get_all_plugins(const LilvWorld* world);
 
+/**
+   Return the plugin that replaces the plugin with URI `plugin_uri`.
+
+   This is a loaded plugin that has a dc:replaces property with the given URI,
+   which is useful for loading sessions that use plugins which are no longer
+   installed.  Only direct replacements are returned, if the replacement is
+   itself replaced, this can be called again with the URI of the replacement.
+
+   Replacements described in plugin data files are found once that data is
+   loaded, so hosts that need them all should first call
+   lilv_world_load_all_plugin_data().
+
+   @return The replacement plugin, or NULL if no loaded plugin replaces it.
+*/
+LILV_API
+const LilvPlugin*
+lilv_world_get_replacement(const LilvWorld* world, const LilvNode* plugin_uri);
+
 /**
    Find nodes matching a triple pattern.
 
@@ -1018,6 +1298,58 @@ LILV_API
 LilvNodes*
 lilv_plugin_get_optional_features(const LilvPlugin* plugin);
 
+/**
+   Create a new set of features.
+
+   Feature sets can be used to quickly check if plugins are supported, since
+   the features of every plugin are recorded as a bit set when it is loaded.
+   A host typically makes a single set of all the features it supports, and
+   uses it to check every plugin.
+
+   @param world The world.
+   @param features A NULL-terminated array of features, or NULL.
+   @return A new feature set which must be freed with lilv_feature_set_free().
+*/
+LILV_API
+LilvFeatureSet*
+lilv_feature_set_new(LilvWorld* world, const LV2_Feature* const* features);
+
+/**
+   Add a feature to a set.
+
+   This can be used to add features that have no data, like lv2:isLive, which
+   are not passed to plugins on instantiation.
+*/
+LILV_API
+void
+lilv_feature_set_add(LilvFeatureSet* set, const LilvNode* uri);
+
+/**
+   Return true iff `set` contains the feature `uri`.
+*/
+LILV_API
+bool
+lilv_feature_set_contains(const LilvFeatureSet* set, const LilvNode* uri);
+
+/**
+   Free a feature set.
+*/
+LILV_API
+void
+lilv_feature_set_free(LilvFeatureSet* set);
+
+/**
+   Return true iff all the features required by a plugin are in `features`.
+
+   This is equivalent to checking that every feature returned by
+   lilv_plugin_get_required_features() is supported, but does not query the
+   world model.
+*/
+LILV_API
+bool
+lilv_plugin_is_supported(const LilvPlugin*     plugin,
+                         const LilvFeatureSet* features);
+
 /**
    Return whether or not a plugin provides a specific extension data.
 */
@@ -1064,6 +1396,69 @@ lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
                                   float*            max_values,
                                   float*            def_values);
 
+/**
+   Standard port classes, as flags for LilvPortTable::classes.
+*/
+typedef enum {
+  LILV_PORT_CLASS_INPUT   = 1U << 0, ///< lv2:InputPort
+  LILV_PORT_CLASS_OUTPUT  = 1U << 1, ///< lv2:OutputPort
+  LILV_PORT_CLASS_CONTROL = 1U << 2, ///< lv2:ControlPort
+  LILV_PORT_CLASS_AUDIO   = 1U << 3, ///< lv2:AudioPort
+  LILV_PORT_CLASS_CV      = 1U << 4, ///< lv2:CVPort
+  LILV_PORT_CLASS_ATOM    = 1U << 5, ///< atom:AtomPort
+  LILV_PORT_CLASS_EVENT   = 1U << 6, ///< ev:EventPort
+} LilvPortClassFlag;
+
+/**
+   Standard port properties, as flags for LilvPortTable::properties.
+*/
+typedef enum {
+  LILV_PORT_PROP_CONNECTION_OPTIONAL = 1U << 0,  ///< lv2:connectionOptional
+  LILV_PORT_PROP_ENUMERATION         = 1U << 1,  ///< lv2:enumeration
+  LILV_PORT_PROP_INTEGER             = 1U << 2,  ///< lv2:integer
+  LILV_PORT_PROP_IS_SIDE_CHAIN       = 1U << 3,  ///< lv2:isSideChain
+  LILV_PORT_PROP_REPORTS_LATENCY     = 1U << 4,  ///< lv2:reportsLatency
+  LILV_PORT_PROP_SAMPLE_RATE         = 1U << 5,  ///< lv2:sampleRate
+  LILV_PORT_PROP_TOGGLED             = 1U << 6,  ///< lv2:toggled
+  LILV_PORT_PROP_CAUSES_ARTIFACTS    = 1U << 7,  ///< pprops:causesArtifacts
+  LILV_PORT_PROP_EXPENSIVE           = 1U << 8,  ///< pprops:expensive
+  LILV_PORT_PROP_HAS_STRICT_BOUNDS   = 1U << 9,  ///< pprops:hasStrictBounds
+  LILV_PORT_PROP_LOGARITHMIC         = 1U << 10, ///< pprops:logarithmic
+  LILV_PORT_PROP_NOT_AUTOMATIC       = 1U << 11, ///< pprops:notAutomatic
+  LILV_PORT_PROP_NOT_ON_GUI          = 1U << 12, ///< pprops:notOnGUI
+  LILV_PORT_PROP_TRIGGER             = 1U << 13, ///< pprops:trigger
+} LilvPortPropertyFlag;
+
+/**
+   A table of commonly used information about all the ports of a plugin.
+
+   Every array has one element for each port, indexed by port index, so this
+   can be used to look up port information without any queries.
+*/
+typedef struct {
+  uint32_t               n_ports;      ///< Number of ports
+  const LilvNode* const* symbols;      ///< Symbol (lv2:symbol)
+  const uint32_t*        classes;      ///< Classes (LilvPortClassFlag)
+  const uint32_t*        properties;   ///< Properties (LilvPortPropertyFlag)
+  const float*           defaults;     ///< Default value, or NAN
+  const float*           minimums;     ///< Minimum value, or NAN
+  const float*           maximums;     ///< Maximum value, or NAN
+  const LilvNode* const* designations; ///< Designation, or NULL
+} LilvPortTable;
+
+/**
+   Get a table of information about all the ports of a plugin.
+
+   The table is built the first time this is called and is owned by the
+   plugin, so it must not be freed.  It remains valid until the plugin is
+   reloaded or the world is destroyed.
+
+   @return The port table for `plugin`, or NULL if the ports are invalid.
+*/
+LILV_API
+const LilvPortTable*
+lilv_plugin_get_port_table(const LilvPlugin* plugin);
+
 /**
    Get the number of ports on this plugin that are members of some class(es).
 
@@ -1838,6 +2233,19 @@ LILV_API
 LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class);
 
+/**
+   Get all plugins in this class or any of its descendant classes.
+
+   This finds plugins by their rdf:type.  The specific class of a plugin is
+   usually only described in its data file, so the data of any plugins that
+   are not yet loaded is first loaded with lilv_world_load_all_plugin_data().
+
+   Returned value must be freed by caller with lilv_plugins_free().
+*/
+LILV_API
+LilvPlugins*
+lilv_plugin_class_get_plugins(const LilvPluginClass* plugin_class);
+
 /**
    @}
    @defgroup lilv_instance Plugin Instances
@@ -1893,6 +2301,117 @@ LILV_API
 void
 lilv_instance_free(LilvInstance* instance);
 
+/**
+   The result of instantiating a plugin.
+*/
+typedef enum {
+  LILV_INSTANTIATE_SUCCESS,    ///< Instance created
+  LILV_INSTANTIATE_BAD_DATA,   ///< Plugin data is invalid or incomplete
+  LILV_INSTANTIATE_NO_LIBRARY, ///< Failed to open plugin library
+  LILV_INSTANTIATE_NO_PLUGIN,  ///< Plugin not found in its library
+  LILV_INSTANTIATE_FAILED,     ///< Plugin failed to instantiate
+} LilvInstantiateStatus;
+
+/**
+   A request to instantiate a plugin with lilv_world_instantiate().
+*/
+typedef struct {
+  const LilvPlugin*         plugin;      ///< Plugin to instantiate
+  double                    sample_rate; ///< Sample rate in Hz
+  const LV2_Feature* const* features;    ///< Supported features, or NULL
+  LilvInstance*             instance;    ///< Set to new instance, or NULL
+  LilvInstantiateStatus     status;      ///< Set to result status
+} LilvInstantiateRequest;
+
+/**
+   Instantiate several plugins with multiple threads.
+
+   This is equivalent to calling lilv_plugin_instantiate() for every request,
+   but loads plugin libraries and creates instances with up to `n_threads`
+   threads.  Plugin data is loaded first, from the calling thread, so the
+   other threads do not modify the world.
+
+   Plugins from the same library are instantiated one at a time, in the order
+   they appear in `requests`, so plugins never see concurrent calls to
+   `instantiate` from their own library.  Plugins from different libraries
+   may be instantiated concurrently, so any features passed must be safe to
+   use from several threads.
+
+   The `instance` and `status` fields of every request are set.  The caller
+   must free every returned instance with lilv_instance_free().
+
+   This modifies the world, so it must not be called concurrently with any
+   other use of it.
+
+   @return The number of instances that were created.
+*/
+LILV_API
+unsigned
+lilv_world_instantiate(LilvWorld*              world,
+                       LilvInstantiateRequest* requests,
+                       size_t                  n_requests,
+                       unsigned                n_threads);
+
+/**
+   Create a pool of ready instances of a plugin.
+
+   This starts a background thread that creates `n_instances` instances of
+   `plugin` with lilv_plugin_instantiate(), so they can later be taken from
+   the pool without the delay of instantiation.  The data and library of the
+   plugin are loaded before this function returns, so the thread does not
+   modify the world, but the world must not be modified until the pool is
+   full (see lilv_instance_pool_wait()).  `features` must remain valid until
+   the pool is freed.
+*/
+LILV_API
+LilvInstancePool*
+lilv_instance_pool_new(const LilvPlugin*         plugin,
+                       double                    sample_rate,
+                       const LV2_Feature* const* features,
+                       unsigned                  n_instances);
+
+/**
+   Wait until the pool has finished creating instances.
+
+   @return The number of instances currently available in the pool.
+*/
+LILV_API
+unsigned
+lilv_instance_pool_wait(LilvInstancePool* pool);
+
+/**
+   Take an instance from the pool.
+
+   This never instantiates the plugin, so it is fast enough to call when
+   adding a plugin to a running graph.
+
+   @return An instance, or NULL if none are currently available.
+*/
+LILV_API
+LilvInstance*
+lilv_instance_pool_acquire(LilvInstancePool* pool);
+
+/**
+   Return an instance to the pool so it can be acquired again.
+
+   The instance must have come from this pool and must be deactivated.  It is
+   reused as is, so hosts that need a fresh instance should restore its state
+   after acquiring it.
+*/
+LILV_API
+void
+lilv_instance_pool_release(LilvInstancePool* pool, LilvInstance* instance);
+
+/**
+   Free a pool and every instance currently in it.
+
+   Instances that have been acquired and not released are not affected, and
+   must be freed with lilv_instance_free().
+*/
+LILV_API
+void
+lilv_instance_pool_free(LilvInstancePool* pool);
+
 #ifndef LILV_INTERNAL
 
 /**
@@ -2008,6 +2527,133 @@ lilv_instance_get_handle(const LilvInstance* instance)
 
 #endif /* LILV_INTERNAL */
 
+/**
+   @}
+   @defgroup lilv_graph Plugin Graphs
+
+   A graph runs several connected plugin instances in dependency order.
+
+   Nodes are added to the graph, then their ports are connected, then the
+   graph is compiled into an execution plan.  Compiling allocates a buffer
+   for every output and unconnected input, and connects every port of every
+   instance, so instances must not be connected or run by anything else
+   while they are in a graph.  After that, lilv_graph_run() runs every
+   instance once, and is realtime safe.
+
+   Audio, CV, and control ports are supported, as are atom ports if the graph
+   has a URID map.  Other ports are connected to NULL, which is only allowed
+   if they have the lv2:connectionOptional property.
+
+   @{
+*/
+
+/**
+   Create a new, empty graph.
+
+   @param block_length Maximum number of frames that can be run at once.
+   @param atom_capacity Size of each atom port buffer in bytes.
+   @param map URID map used for atom ports, or NULL to not support them.
+   @param n_threads Number of threads to run with, including the one that
+   calls lilv_graph_run().  Instances that do not depend on each other may be
+   run in parallel, so they must not share any state that is not thread-safe.
+*/
+LILV_API
+LilvGraph*
+lilv_graph_new(uint32_t      block_length,
+               uint32_t      atom_capacity,
+               LV2_URID_Map* map,
+               unsigned      n_threads);
+
+/**
+   Add a plugin instance to a graph.
+
+   Nodes are numbered in the order they are added, starting from zero.  The
+   graph does not take ownership of `instance`, which must outlive it, and
+   the host is still responsible for activating and deactivating it.
+
+   @return Zero on success, or non-zero if the ports of `plugin` are invalid.
+*/
+LILV_API
+int
+lilv_graph_add(LilvGraph*        graph,
+               const LilvPlugin* plugin,
+               LilvInstance*     instance);
+
+/**
+   Connect an output port of one node to an input port of another.
+
+   The ports must have the same type, except that audio and CV ports may be
+   connected to each other.  Each input may have at most one connection.
+
+   @return Zero on success, or non-zero if the connection is invalid.
+*/
+LILV_API
+int
+lilv_graph_connect(LilvGraph* graph,
+                   uint32_t   src_node,
+                   uint32_t   src_port,
+                   uint32_t   dst_node,
+                   uint32_t   dst_port);
+
+/**
+   Compile a graph so that it can be run.
+
+   This sorts the nodes into levels that only depend on earlier levels, then
+   allocates buffers and connects every port.  Unconnected control inputs are
+   set to their default value.  This must be called again after the graph is
+   changed, and must not be called while the graph is running.
+
+   @return Zero on success, or non-zero if the graph has a cycle or a port
+   that can not be connected.
+*/
+LILV_API
+int
+lilv_graph_compile(LilvGraph* graph);
+
+/**
+   Get the order that nodes are run in.
+
+   @return An array of every node index in execution order, which is owned by
+   the graph and valid until it is compiled again, or NULL if the graph is not
+   compiled.
+*/
+LILV_API
+const uint32_t*
+lilv_graph_get_order(const LilvGraph* graph);
+
+/**
+   Get the buffer connected to a port in a compiled graph.
+
+   This can be used to provide input to unconnected inputs, or read outputs,
+   between runs.  Buffers are aligned to a typical cache line size.
+
+   @return The buffer of the port, or NULL if the graph is not compiled, or
+   the port is invalid or not connected.
+*/
+LILV_API
+void*
+lilv_graph_get_buffer(const LilvGraph* graph, uint32_t node, uint32_t port);
+
+/**
+   Run every node in a compiled graph once.
+
+   Atom outputs are reset to their capacity before their node is run.  This
+   does nothing if the graph is not compiled or `n_frames` is greater than
+   the block length of the graph.
+*/
+LILV_API
+void
+lilv_graph_run(LilvGraph* graph, uint32_t n_frames);
+
+/**
+   Free a graph.
+
+   This does not free the instances in the graph.
+*/
+LILV_API
+void
+lilv_graph_free(LilvGraph* graph);
+
 /**
    @}
    @defgroup lilv_ui Plugin UIs
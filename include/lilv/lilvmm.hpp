@@ -177,6 +177,7 @@ struct PluginClass {
   LILV_WRAP0(Node, plugin_class, get_uri);
   LILV_WRAP0(Node, plugin_class, get_label);
   LILV_WRAP0(LilvPluginClasses*, plugin_class, get_children);
+  LILV_WRAP0(LilvPlugins*, plugin_class, get_plugins);
 
   const LilvPluginClass* me;
 };
@@ -281,7 +282,9 @@ struct Plugin {
   LILV_WRAP0(Nodes, plugin, get_supported_features);
   LILV_WRAP0(Nodes, plugin, get_required_features);
   LILV_WRAP0(Nodes, plugin, get_optional_features);
+  LILV_WRAP1(bool, plugin, is_supported, const LilvFeatureSet*, features);
   LILV_WRAP0(unsigned, plugin, get_num_ports);
+  LILV_WRAP0(const LilvPortTable*, plugin, get_port_table);
   LILV_WRAP0(bool, plugin, has_latency);
   LILV_WRAP0(unsigned, plugin, get_latency_port_index);
   LILV_WRAP0(Node, plugin, get_author_name);
@@ -426,6 +429,34 @@ struct World {
 
   LILV_WRAP2_VOID(world, set_option, const char*, uri, LilvNode*, value);
   LILV_WRAP0_VOID(world, load_all);
+  LILV_WRAP0_VOID(world, load_all_plugin_data);
+  LILV_WRAP0_VOID(world, freeze);
+  LILV_WRAP0(unsigned, world, trim_libraries);
+
+  inline unsigned preload_libraries(const LilvPlugin* const*  plugins,
+                                    size_t                    n_plugins,
+                                    const LV2_Feature* const* features,
+                                    unsigned                  n_threads)
+  {
+    return lilv_world_preload_libraries(
+      me, plugins, n_plugins, features, n_threads);
+  }
+
+  LILV_WRAP3(unsigned,
+             world,
+             instantiate,
+             LilvInstantiateRequest*,
+             requests,
+             size_t,
+             n_requests,
+             unsigned,
+             n_threads);
+
+  LILV_WRAP0(LilvWorldStats, world, get_stats);
+  LILV_WRAP1_VOID(world, print_stats, FILE*, stream);
+  LILV_WRAP0(int, world, rescan);
+  LILV_WRAP0(int, world, watch);
+  LILV_WRAP0(int, world, process_changes);
   LILV_WRAP1_VOID(world, load_bundle, LilvNode*, bundle_uri);
   LILV_WRAP0(const LilvPluginClass*, world, get_plugin_class);
   LILV_WRAP0(const LilvPluginClasses*, world, get_plugin_classes);
@@ -0,0 +1,90 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Size of the data in a standard arena block. */
+#define LILV_ARENA_BLOCK_SIZE 16384U
+
+/** Type with the strictest alignment requirement of anything allocated. */
+typedef union {
+  void*       pointer;
+  double      real;
+  uint64_t    integer;
+  long double long_real;
+} LilvArenaAlign;
+
+/** Round `size` up to a multiple of the arena alignment. */
+#define LILV_ARENA_ROUND(size) \
+  (((size) + sizeof(LilvArenaAlign) - 1U) / sizeof(LilvArenaAlign) * \
+   sizeof(LilvArenaAlign))
+
+struct LilvArenaBlockImpl {
+  LilvArenaBlock* next; ///< Next (older) block
+  size_t          size; ///< Size of data in block
+  size_t          used; ///< Number of bytes of data in use
+};
+
+/** Size of a block header, so the following data is aligned. */
+#define LILV_ARENA_HEADER_SIZE LILV_ARENA_ROUND(sizeof(LilvArenaBlock))
+
+void*
+lilv_arena_alloc(LilvArena* arena, size_t size)
+{
+  size = LILV_ARENA_ROUND(size);
+
+  LilvArenaBlock* block = arena->blocks;
+  if (!block || block->size - block->used < size) {
+    // Large objects get a block of their own, others a standard block
+    const size_t data_size =
+      size > LILV_ARENA_BLOCK_SIZE / 4U ? size : LILV_ARENA_BLOCK_SIZE;
+
+    if (!(block = (LilvArenaBlock*)calloc(1, LILV_ARENA_HEADER_SIZE +
+                                                data_size))) {
+      return NULL;
+    }
+
+    block->size = data_size;
+    if (data_size == size && arena->blocks) {
+      // Insert after the current block, which may still have room
+      block->next         = arena->blocks->next;
+      arena->blocks->next = block;
+    } else {
+      block->next   = arena->blocks;
+      arena->blocks = block;
+    }
+  }
+
+  char* const ptr = (char*)block + LILV_ARENA_HEADER_SIZE + block->used;
+  block->used += size;
+  return ptr;
+}
+
+void
+lilv_arena_clear(LilvArena* arena)
+{
+  for (LilvArenaBlock* block = arena->blocks; block;) {
+    LilvArenaBlock* const next = block->next;
+    free(block);
+    block = next;
+  }
+
+  arena->blocks = NULL;
+}
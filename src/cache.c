@@ -0,0 +1,536 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/*
+  On-disk cache of parsed data files.
+
+  Each cached file is stored in its own cache file, named by a hash of the
+  path, which contains:
+
+  - Header: magic, version, byte order mark, source file size and mtime
+  - Source file path (to detect hash collisions)
+  - Node table: type, datatype index, language, and string of every node
+  - Statement table: subject, predicate, and object node indices
+
+  All integers are in native byte order, and all strings are stored with a
+  null terminator so they can be used directly from the loaded buffer.  Blank
+  node labels are stored without the blank node prefix, which is added again
+  when the cache is loaded, so cached data can be loaded into any world.
+*/
+
+#include "filesystem.h"
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "serd/serd.h"
+#include "sord/sord.h"
+#include "zix/common.h"
+#include "zix/tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char lilv_cache_magic[8] =
+  {'L', 'I', 'L', 'V', 'C', 'C', 'H', 'E'};
+
+static const uint32_t lilv_cache_version = 1U;
+static const uint32_t lilv_cache_bom     = 0x01020304U;
+
+static char*
+cache_file_path(const char* cache_dir, const char* path)
+{
+  const uint64_t hash = lilv_hash_bytes(path, strlen(path));
+
+  char name[24];
+  snprintf(name,
+           sizeof(name),
+           "%08x%08x.cache",
+           (unsigned)(hash >> 32U),
+           (unsigned)(hash & 0xFFFFFFFFU));
+
+  return lilv_path_join(cache_dir, name);
+}
+
+/*
+ * Reading
+ */
+
+typedef struct {
+  const uint8_t* buf;
+  size_t         len;
+  size_t         pos;
+  bool           error;
+} CacheReader;
+
+static const void*
+read_bytes(CacheReader* reader, const size_t n)
+{
+  if (reader->error || n > reader->len - reader->pos) {
+    reader->error = true;
+    return NULL;
+  }
+
+  const void* const ptr = reader->buf + reader->pos;
+  reader->pos += n;
+  return ptr;
+}
+
+static uint32_t
+read_u32(CacheReader* reader)
+{
+  uint32_t          value = 0;
+  const void* const ptr   = read_bytes(reader, sizeof(value));
+  if (ptr) {
+    memcpy(&value, ptr, sizeof(value));
+  }
+  return value;
+}
+
+static uint64_t
+read_u64(CacheReader* reader)
+{
+  uint64_t          value = 0;
+  const void* const ptr   = read_bytes(reader, sizeof(value));
+  if (ptr) {
+    memcpy(&value, ptr, sizeof(value));
+  }
+  return value;
+}
+
+/** Read a length-prefixed null-terminated string, or return NULL. */
+static const char*
+read_string(CacheReader* reader, uint32_t* len)
+{
+  *len = read_u32(reader);
+  if (reader->error || *len >= reader->len - reader->pos) {
+    reader->error = true; // Truncated, or an absurd length
+    return NULL;
+  }
+
+  const char* const str = (const char*)read_bytes(reader, (size_t)*len + 1U);
+  if (str && str[*len] != '\0') {
+    reader->error = true;
+    return NULL;
+  }
+
+  return str;
+}
+
+static uint8_t*
+read_file(const char* path, size_t* len)
+{
+  FILE* const fd = fopen(path, "rb");
+  if (!fd) {
+    return NULL;
+  }
+
+  uint8_t* buf = NULL;
+  long     end = -1;
+  if (!fseek(fd, 0, SEEK_END) && (end = ftell(fd)) > 0 &&
+      !fseek(fd, 0, SEEK_SET)) {
+    buf  = (uint8_t*)malloc((size_t)end);
+    *len = fread(buf, 1, (size_t)end, fd);
+    if (*len != (size_t)end) {
+      free(buf);
+      buf = NULL;
+    }
+  }
+
+  fclose(fd);
+  return buf;
+}
+
+static bool
+read_header(CacheReader*   reader,
+            const char*    path,
+            const uint64_t size,
+            const int64_t  mtime)
+{
+  const void* const magic = read_bytes(reader, sizeof(lilv_cache_magic));
+  if (!magic || memcmp(magic, lilv_cache_magic, sizeof(lilv_cache_magic)) ||
+      read_u32(reader) != lilv_cache_version ||
+      read_u32(reader) != lilv_cache_bom || read_u64(reader) != size ||
+      (int64_t)read_u64(reader) != mtime) {
+    return false;
+  }
+
+  uint32_t          path_len   = 0;
+  const char* const saved_path = read_string(reader, &path_len);
+
+  return saved_path && !strcmp(saved_path, path);
+}
+
+static SordNode*
+read_node(CacheReader*     reader,
+          SordWorld*       world,
+          SordNode* const* nodes,
+          const uint32_t   n_nodes,
+          const uint8_t*   blank_prefix)
+{
+  const uint32_t type     = read_u32(reader);
+  const uint32_t datatype = read_u32(reader);
+  uint32_t       lang_len = 0;
+  const char*    lang     = read_string(reader, &lang_len);
+  uint32_t       len      = 0;
+  const char*    str      = read_string(reader, &len);
+  SordNode*      node     = NULL;
+  if (reader->error || datatype > n_nodes) {
+    reader->error = true;
+    return NULL;
+  }
+
+  switch (type) {
+  case SORD_URI:
+    node = sord_new_uri(world, (const uint8_t*)str);
+    break;
+  case SORD_BLANK: {
+    char* const label = lilv_strjoin((const char*)blank_prefix, str, NULL);
+    node              = sord_new_blank(world, (const uint8_t*)label);
+    free(label);
+    break;
+  }
+  case SORD_LITERAL:
+    node = sord_new_literal(world,
+                            datatype ? nodes[datatype - 1U] : NULL,
+                            (const uint8_t*)str,
+                            lang_len ? lang : NULL);
+    break;
+  default:
+    reader->error = true;
+  }
+
+  return node;
+}
+
+/** Load a cache file into `model`, returning SERD_FAILURE if it is stale. */
+static SerdStatus
+cache_read(const char*    cache_path,
+           const char*    path,
+           const uint64_t size,
+           const int64_t  mtime,
+           SordModel*     model,
+           SordNode*      graph,
+           const uint8_t* blank_prefix)
+{
+  size_t         len = 0;
+  uint8_t* const buf = read_file(cache_path, &len);
+  if (!buf) {
+    return SERD_FAILURE;
+  }
+
+  CacheReader reader = {buf, len, 0U, false};
+  if (!read_header(&reader, path, size, mtime)) {
+    free(buf);
+    return SERD_FAILURE;
+  }
+
+  SordWorld* const world   = sord_get_world(model);
+  const uint32_t   n_nodes = read_u32(&reader);
+  if (reader.error || n_nodes > (len - reader.pos) / 4U) {
+    free(buf);
+    return SERD_FAILURE;
+  }
+
+  SordNode** const nodes  = (SordNode**)calloc(n_nodes, sizeof(SordNode*));
+  uint32_t         n_read = 0U;
+  for (; n_read < n_nodes && !reader.error; ++n_read) {
+    nodes[n_read] = read_node(&reader, world, nodes, n_read, blank_prefix);
+  }
+
+  // Check that every statement is valid before adding anything
+  const uint32_t n_statements = read_u32(&reader);
+  const size_t   start        = reader.pos;
+  if (!reader.error && (uint64_t)n_statements > (len - reader.pos) / 12U) {
+    reader.error = true; // Truncated, or an absurd number of statements
+  }
+
+  for (uint64_t i = 0U; !reader.error && i < 3U * (uint64_t)n_statements; ++i) {
+    const uint32_t index = read_u32(&reader);
+    if (index >= n_nodes || !nodes[index]) {
+      reader.error = true;
+    }
+  }
+
+  if (!reader.error) {
+    reader.pos = start;
+    for (uint32_t i = 0U; i < n_statements; ++i) {
+      const SordNode* const s = nodes[read_u32(&reader)];
+      const SordNode* const p = nodes[read_u32(&reader)];
+      const SordNode* const o = nodes[read_u32(&reader)];
+
+      SordQuad quad = {s, p, o, graph};
+      sord_add(model, quad);
+    }
+  }
+
+  for (uint32_t i = 0U; i < n_read; ++i) {
+    sord_node_free(world, nodes[i]);
+  }
+
+  free(nodes);
+  free(buf);
+  return reader.error ? SERD_FAILURE : SERD_SUCCESS;
+}
+
+/*
+ * Writing
+ */
+
+typedef struct {
+  const SordNode* node;
+  uint32_t        index;
+} CacheEntry;
+
+typedef struct {
+  ZixTree*         index; ///< Node => CacheEntry
+  const SordNode** nodes; ///< Nodes in index order
+  uint32_t         n_nodes;
+  const uint8_t*   blank_prefix;
+  size_t           prefix_len;
+  FILE*            out;
+  bool             error;
+} CacheWriter;
+
+static int
+entry_cmp(const void* a, const void* b, const void* user_data)
+{
+  (void)user_data;
+
+  const CacheEntry* const entry_a = (const CacheEntry*)a;
+  const CacheEntry* const entry_b = (const CacheEntry*)b;
+
+  return lilv_ptr_cmp(entry_a->node, entry_b->node, NULL);
+}
+
+/** Return the 1-based index of `node`, adding it to the table if necessary. */
+static uint32_t
+node_index(CacheWriter* writer, const SordNode* node)
+{
+  if (!node) {
+    return 0U;
+  }
+
+  const CacheEntry key  = {node, 0U};
+  ZixTreeIter*     iter = NULL;
+  if (!zix_tree_find(writer->index, &key, &iter)) {
+    return ((const CacheEntry*)zix_tree_get(iter))->index;
+  }
+
+  // Add datatype first so it is always defined before it is used
+  node_index(writer, sord_node_get_datatype(node));
+
+  CacheEntry* const entry = (CacheEntry*)malloc(sizeof(CacheEntry));
+  entry->node             = node;
+  entry->index            = ++writer->n_nodes;
+  zix_tree_insert(writer->index, entry, NULL);
+
+  writer->nodes = (const SordNode**)realloc(
+    writer->nodes, writer->n_nodes * sizeof(const SordNode*));
+  writer->nodes[writer->n_nodes - 1U] = node;
+  return entry->index;
+}
+
+static void
+write_bytes(CacheWriter* writer, const void* buf, const size_t len)
+{
+  if (!writer->error && fwrite(buf, 1, len, writer->out) != len) {
+    writer->error = true;
+  }
+}
+
+static void
+write_u32(CacheWriter* writer, const uint32_t value)
+{
+  write_bytes(writer, &value, sizeof(value));
+}
+
+static void
+write_u64(CacheWriter* writer, const uint64_t value)
+{
+  write_bytes(writer, &value, sizeof(value));
+}
+
+static void
+write_string(CacheWriter* writer, const char* str, const size_t len)
+{
+  write_u32(writer, (uint32_t)len);
+  write_bytes(writer, str ? str : "", len);
+  write_bytes(writer, "", 1U);
+}
+
+static void
+write_node(CacheWriter* writer, const SordNode* node)
+{
+  const SordNodeType type = sord_node_get_type(node);
+  const char* const  lang = sord_node_get_language(node);
+  size_t             len  = 0U;
+  const char*        str =
+    (const char*)sord_node_get_string_counted(node, &len);
+
+  if (type == SORD_BLANK &&
+      !strncmp(str, (const char*)writer->blank_prefix, writer->prefix_len)) {
+    // Strip blank node prefix, it will be replaced when loaded
+    str += writer->prefix_len;
+    len -= writer->prefix_len;
+  }
+
+  write_u32(writer, (uint32_t)type);
+  write_u32(writer, node_index(writer, sord_node_get_datatype(node)));
+  write_string(writer, lang, lang ? strlen(lang) : 0U);
+  write_string(writer, str, len);
+}
+
+/** Write all statements in `model` to a new cache file. */
+static int
+cache_write(const char*    cache_dir,
+            const char*    cache_path,
+            const char*    path,
+            const uint64_t size,
+            const int64_t  mtime,
+            SordModel*     model,
+            const uint8_t* blank_prefix)
+{
+  CacheWriter writer = {zix_tree_new(false, entry_cmp, NULL, free),
+                        NULL,
+                        0U,
+                        blank_prefix,
+                        strlen((const char*)blank_prefix),
+                        NULL,
+                        false};
+
+  // Build node table and statement table
+  const size_t    n_statements = sord_num_quads(model);
+  uint32_t* const statements =
+    (uint32_t*)calloc(3U * n_statements + 1U, sizeof(uint32_t));
+  size_t    n = 0U;
+  SordIter* i = sord_begin(model);
+  for (; !sord_iter_end(i) && n < 3U * n_statements; sord_iter_next(i)) {
+    SordQuad quad;
+    sord_iter_get(i, quad);
+    statements[n++] = node_index(&writer, quad[SORD_SUBJECT]) - 1U;
+    statements[n++] = node_index(&writer, quad[SORD_PREDICATE]) - 1U;
+    statements[n++] = node_index(&writer, quad[SORD_OBJECT]) - 1U;
+  }
+  sord_iter_free(i);
+
+  // Write to a temporary file, then move it into place
+  char* const tmp_path = lilv_strjoin(cache_path, ".XXXXXX", NULL);
+  if (!lilv_create_directories(cache_dir) &&
+      (writer.out = lilv_create_temporary_file(tmp_path))) {
+    write_bytes(&writer, lilv_cache_magic, sizeof(lilv_cache_magic));
+    write_u32(&writer, lilv_cache_version);
+    write_u32(&writer, lilv_cache_bom);
+    write_u64(&writer, size);
+    write_u64(&writer, (uint64_t)mtime);
+    write_string(&writer, path, strlen(path));
+
+    write_u32(&writer, writer.n_nodes);
+    for (uint32_t j = 0U; j < writer.n_nodes; ++j) {
+      write_node(&writer, writer.nodes[j]);
+    }
+
+    write_u32(&writer, (uint32_t)(n / 3U));
+    write_bytes(&writer, statements, n * sizeof(uint32_t));
+
+    writer.error = fclose(writer.out) || writer.error;
+    if (writer.error || lilv_replace_file(tmp_path, cache_path)) {
+      lilv_remove(tmp_path);
+      writer.error = true;
+    }
+  } else {
+    writer.error = true;
+  }
+
+  free(tmp_path);
+  free(statements);
+  free(writer.nodes);
+  zix_tree_free(writer.index);
+  return writer.error;
+}
+
+/*
+ * Loading
+ */
+
+static SerdStatus
+parse_file(SordModel* model, const char* uri, const uint8_t* blank_prefix)
+{
+  const SerdNode base   = serd_node_from_string(SERD_URI, (const uint8_t*)uri);
+  SerdEnv*       env    = serd_env_new(&base);
+  SerdReader*    reader = sord_new_reader(model, env, SERD_TURTLE, NULL);
+
+  serd_reader_add_blank_prefix(reader, blank_prefix);
+  const SerdStatus st = serd_reader_read_file(reader, (const uint8_t*)uri);
+
+  serd_reader_free(reader);
+  serd_env_free(env);
+  return st;
+}
+
+SerdStatus
+lilv_cache_load_file(const char*    cache_dir,
+                     SordModel*     model,
+                     SordNode*      graph,
+                     const char*    uri,
+                     const uint8_t* blank_prefix,
+                     bool*          cached)
+{
+  *cached = false;
+
+  char* const path  = lilv_file_uri_parse(uri, NULL);
+  uint64_t    size  = 0U;
+  int64_t     mtime = 0;
+  if (!path || lilv_file_stamp(path, &size, &mtime)) {
+    lilv_free(path);
+    return SERD_ERR_BAD_ARG;
+  }
+
+  // Load from cache if it is up to date
+  char* const cache_path = cache_file_path(cache_dir, path);
+  if (!cache_read(
+        cache_path, path, size, mtime, model, graph, blank_prefix)) {
+    free(cache_path);
+    lilv_free(path);
+    *cached = true;
+    return SERD_SUCCESS;
+  }
+
+  // Otherwise, parse into a temporary model and save it to the cache
+  SordModel* const temp = sord_new(sord_get_world(model), SORD_SPO, false);
+  const SerdStatus st   = parse_file(temp, uri, blank_prefix);
+  if (!st && cache_write(
+               cache_dir, cache_path, path, size, mtime, temp, blank_prefix)) {
+    LILV_WARNF("Failed to write cache file `%s'\n", cache_path);
+  }
+
+  SordIter* i = sord_begin(temp);
+  for (; !sord_iter_end(i); sord_iter_next(i)) {
+    SordQuad quad;
+    sord_iter_get(i, quad);
+    quad[SORD_GRAPH] = graph;
+    sord_add(model, quad);
+  }
+  sord_iter_free(i);
+
+  sord_free(temp);
+  free(cache_path);
+  lilv_free(path);
+  return st;
+}
@@ -24,13 +24,15 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 int
 lilv_ptr_cmp(const void* a, const void* b, const void* user_data)
 {
   (void)user_data;
 
-  return (intptr_t)a - (intptr_t)b;
+  return (uintptr_t)a < (uintptr_t)b ? -1 : (uintptr_t)a > (uintptr_t)b;
 }
 
 int
@@ -41,35 +43,64 @@ lilv_resource_node_cmp(const void* a, const void* b, const void* user_data)
   const SordNode* an = ((const LilvNode*)a)->node;
   const SordNode* bn = ((const LilvNode*)b)->node;
 
-  return (intptr_t)an - (intptr_t)bn;
+  return lilv_ptr_cmp(an, bn, NULL);
 }
 
 /* Generic collection functions */
 
-static inline LilvCollection*
+/**
+   A collection of objects.
+
+   Collections are built once then only read, so rather than a tree, they are
+   a sorted array of pointers.  This avoids an allocation for every element,
+   and iterating over a collection is just incrementing a pointer, since an
+   iterator is a pointer to an element in the array.
+*/
+struct LilvCollectionImpl {
+  ZixComparator  cmp;      ///< Element comparator
+  ZixDestroyFunc destroy;  ///< Element destructor, or NULL
+  void**         elems;    ///< Sorted array of elements
+  unsigned       size;     ///< Number of elements
+  unsigned       capacity; ///< Number of allocated elements
+};
+
+LilvCollection*
 lilv_collection_new(ZixComparator cmp, ZixDestroyFunc destructor)
 {
-  return zix_tree_new(false, cmp, NULL, destructor);
+  LilvCollection* collection =
+    (LilvCollection*)calloc(1, sizeof(LilvCollection));
+
+  collection->cmp     = cmp;
+  collection->destroy = destructor;
+  return collection;
 }
 
 void
 lilv_collection_free(LilvCollection* collection)
 {
   if (collection) {
-    zix_tree_free((ZixTree*)collection);
+    if (collection->destroy) {
+      for (unsigned i = 0; i < collection->size; ++i) {
+        collection->destroy(collection->elems[i]);
+      }
+    }
+
+    free(collection->elems);
+    free(collection);
   }
 }
 
 unsigned
 lilv_collection_size(const LilvCollection* collection)
 {
-  return (collection ? zix_tree_size((const ZixTree*)collection) : 0);
+  return (collection ? collection->size : 0);
 }
 
 LilvIter*
 lilv_collection_begin(const LilvCollection* collection)
 {
-  return collection ? (LilvIter*)zix_tree_begin((ZixTree*)collection) : NULL;
+  return (collection && collection->size) ? (LilvIter*)collection->elems
+                                          : NULL;
 }
 
 void*
@@ -77,7 +108,82 @@ lilv_collection_get(const LilvCollection* collection, const LilvIter* i)
 {
   (void)collection;
 
-  return zix_tree_get((const ZixTreeIter*)i);
+  return i ? *(void* const*)i : NULL;
+}
+
+/** Return the index of the first element that is not less than `key`. */
+static unsigned
+lilv_collection_lower_bound(const LilvCollection* collection, const void* key)
+{
+  unsigned lo = 0;
+  unsigned hi = collection->size;
+  while (lo < hi) {
+    const unsigned mid = lo + ((hi - lo) / 2);
+    if (collection->cmp(key, collection->elems[mid], NULL) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+ZixStatus
+lilv_collection_insert(LilvCollection* collection, void* elem)
+{
+  // Elements are usually added in order, so check the end first
+  unsigned index = collection->size;
+  if (index && collection->cmp(elem, collection->elems[index - 1], NULL) <= 0) {
+    index = lilv_collection_lower_bound(collection, elem);
+    if (!collection->cmp(elem, collection->elems[index], NULL)) {
+      if (collection->destroy) {
+        collection->destroy(elem);
+      }
+
+      return ZIX_STATUS_EXISTS;
+    }
+  }
+
+  if (collection->size == collection->capacity) {
+    const unsigned capacity = collection->capacity ? collection->capacity * 2U
+                                                   : 4U;
+    void** const   elems =
+      (void**)realloc(collection->elems, capacity * sizeof(void*));
+    if (!elems) {
+      if (collection->destroy) {
+        collection->destroy(elem);
+      }
+
+      return ZIX_STATUS_NO_MEM;
+    }
+
+    collection->elems    = elems;
+    collection->capacity = capacity;
+  }
+
+  memmove(collection->elems + index + 1,
+          collection->elems + index,
+          (collection->size - index) * sizeof(void*));
+
+  collection->elems[index] = elem;
+  ++collection->size;
+  return ZIX_STATUS_SUCCESS;
+}
+
+void*
+lilv_collection_find(const LilvCollection* collection, const void* key)
+{
+  if (!collection) {
+    return NULL;
+  }
+
+  const unsigned index = lilv_collection_lower_bound(collection, key);
+
+  return (index < collection->size &&
+          !collection->cmp(key, collection->elems[index], NULL))
+           ? collection->elems[index]
+           : NULL;
 }
 
 /* Constructors */
@@ -115,14 +221,13 @@ const LilvPluginClass*
 lilv_plugin_classes_get_by_uri(const LilvPluginClasses* classes,
                                const LilvNode*          uri)
 {
-  return (LilvPluginClass*)lilv_collection_get_by_uri((const ZixTree*)classes,
-                                                      uri);
+  return (LilvPluginClass*)lilv_collection_get_by_uri(classes, uri);
 }
 
 const LilvUI*
 lilv_uis_get_by_uri(const LilvUIs* uis, const LilvNode* uri)
 {
-  return (LilvUI*)lilv_collection_get_by_uri((const ZixTree*)uis, uri);
+  return (LilvUI*)lilv_collection_get_by_uri(uis, uri);
 }
 
 /* Plugins */
@@ -130,13 +235,52 @@ lilv_uis_get_by_uri(const LilvUIs* uis, const LilvNode* uri)
 LilvPlugins*
 lilv_plugins_new(void)
 {
-  return lilv_collection_new(lilv_header_compare_by_uri, NULL);
+  return zix_tree_new(false, lilv_header_compare_by_uri, NULL, NULL);
 }
 
 const LilvPlugin*
 lilv_plugins_get_by_uri(const LilvPlugins* plugins, const LilvNode* uri)
 {
-  return (LilvPlugin*)lilv_collection_get_by_uri((const ZixTree*)plugins, uri);
+  return (LilvPlugin*)lilv_tree_get_by_uri((const ZixTree*)plugins, uri);
+}
+
+unsigned
+lilv_plugins_size(const LilvPlugins* collection)
+{
+  return (collection ? zix_tree_size((const ZixTree*)collection) : 0);
+}
+
+LilvIter*
+lilv_plugins_begin(const LilvPlugins* collection)
+{
+  return collection ? (LilvIter*)zix_tree_begin((ZixTree*)collection) : NULL;
+}
+
+const LilvPlugin*
+lilv_plugins_get(const LilvPlugins* collection, LilvIter* i)
+{
+  (void)collection;
+  return (const LilvPlugin*)zix_tree_get((const ZixTreeIter*)i);
+}
+
+LilvIter*
+lilv_plugins_next(const LilvPlugins* collection, LilvIter* i)
+{
+  (void)collection;
+  return zix_tree_iter_next((ZixTreeIter*)i);
+}
+
+bool
+lilv_plugins_is_end(const LilvPlugins* collection, LilvIter* i)
+{
+  (void)collection;
+  return zix_tree_iter_is_end((ZixTreeIter*)i);
+}
+
+void
+lilv_plugins_free(LilvPlugins* collection)
+{
+  zix_tree_free((ZixTree*)collection);
 }
 
 /* Nodes */
@@ -144,6 +288,12 @@ lilv_plugins_get_by_uri(const LilvPlugins* plugins, const LilvNode* uri)
 bool
 lilv_nodes_contains(const LilvNodes* nodes, const LilvNode* value)
 {
+  const LilvNode* const first = lilv_nodes_get_first(nodes);
+  if ((lilv_node_is_uri(value) || lilv_node_is_blank(value)) && first &&
+      first->world == value->world) {
+    return lilv_collection_find(nodes, value); // Interned, find by pointer
+  }
+
   LILV_FOREACH (nodes, i, nodes) {
     if (lilv_node_equals(lilv_nodes_get(nodes, i), value)) {
       return true;
@@ -159,13 +309,11 @@ lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b)
   LilvNodes* result = lilv_nodes_new();
 
   LILV_FOREACH (nodes, i, a) {
-    zix_tree_insert(
-      (ZixTree*)result, lilv_node_duplicate(lilv_nodes_get(a, i)), NULL);
+    lilv_collection_insert(result, lilv_node_duplicate(lilv_nodes_get(a, i)));
   }
 
   LILV_FOREACH (nodes, i, b) {
-    zix_tree_insert(
-      (ZixTree*)result, lilv_node_duplicate(lilv_nodes_get(b, i)), NULL);
+    lilv_collection_insert(result, lilv_node_duplicate(lilv_nodes_get(b, i)));
   }
 
   return result;
@@ -193,20 +341,19 @@ lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b)
   LilvIter* prefix##_next(const CT* collection, LilvIter* i) \
   {                                                          \
     (void)collection;                                        \
-    return zix_tree_iter_next((ZixTreeIter*)i);              \
+    return (LilvIter*)((void**)i + 1);                       \
   }                                                          \
                                                              \
   bool prefix##_is_end(const CT* collection, LilvIter* i)    \
   {                                                          \
-    (void)collection;                                        \
-    return zix_tree_iter_is_end((ZixTreeIter*)i);            \
+    const LilvCollection* const c = collection;              \
+    return !i || !c || (void**)i >= c->elems + c->size;      \
   }
 
 LILV_COLLECTION_IMPL(lilv_plugin_classes, LilvPluginClasses, LilvPluginClass)
 LILV_COLLECTION_IMPL(lilv_scale_points, LilvScalePoints, LilvScalePoint)
 LILV_COLLECTION_IMPL(lilv_uis, LilvUIs, LilvUI)
 LILV_COLLECTION_IMPL(lilv_nodes, LilvNodes, LilvNode)
-LILV_COLLECTION_IMPL(lilv_plugins, LilvPlugins, LilvPlugin)
 
 void
 lilv_plugin_classes_free(LilvPluginClasses* collection)
@@ -0,0 +1,259 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "lv2/core/lv2.h"
+#include "sord/sord.h"
+#include "zix/hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct LilvFeatureSetImpl {
+  LilvWorld* world;
+  LilvBitset bits;
+};
+
+/** An entry in the world feature registry. */
+typedef struct {
+  const SordNode* uri; ///< Feature URI
+  uint32_t        id;  ///< Index in world->feature_uris
+} LilvFeatureEntry;
+
+/* Bit sets */
+
+void
+lilv_bitset_set(LilvBitset* bits, uint32_t index)
+{
+  const uint32_t word = index / 64U;
+  if (word >= bits->n_words) {
+    const uint32_t n_words = word + 1U;
+
+    bits->words = (uint64_t*)realloc(bits->words, n_words * sizeof(uint64_t));
+    memset(bits->words + bits->n_words,
+           0,
+           (n_words - bits->n_words) * sizeof(uint64_t));
+
+    bits->n_words = n_words;
+  }
+
+  bits->words[word] |= (uint64_t)1U << (index % 64U);
+}
+
+bool
+lilv_bitset_has(const LilvBitset* bits, uint32_t index)
+{
+  const uint32_t word = index / 64U;
+
+  return word < bits->n_words &&
+         (bits->words[word] & ((uint64_t)1U << (index % 64U)));
+}
+
+bool
+lilv_bitset_is_subset(const LilvBitset* a, const LilvBitset* b)
+{
+  for (uint32_t i = 0U; i < a->n_words; ++i) {
+    const uint64_t b_word = i < b->n_words ? b->words[i] : 0U;
+    if (a->words[i] & ~b_word) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void
+lilv_bitset_clear(LilvBitset* bits)
+{
+  free(bits->words);
+  bits->words   = NULL;
+  bits->n_words = 0U;
+}
+
+/* Feature registry */
+
+static uint32_t
+lilv_feature_entry_hash(const void* value)
+{
+  const SordNode* const uri = ((const LilvFeatureEntry*)value)->uri;
+
+  return (uint32_t)lilv_hash_bytes(&uri, sizeof(uri));
+}
+
+static bool
+lilv_feature_entry_equals(const void* a, const void* b)
+{
+  return ((const LilvFeatureEntry*)a)->uri == ((const LilvFeatureEntry*)b)->uri;
+}
+
+ZixHash*
+lilv_feature_registry_new(void)
+{
+  return zix_hash_new(lilv_feature_entry_hash,
+                      lilv_feature_entry_equals,
+                      sizeof(LilvFeatureEntry));
+}
+
+/** Find the ID of a feature, which must be called with the node lock held. */
+static bool
+lilv_world_find_feature_locked(const LilvWorld* world,
+                               const SordNode*  uri,
+                               uint32_t*        id)
+{
+  const LilvFeatureEntry        key = {uri, 0U};
+  const LilvFeatureEntry* const entry =
+    (const LilvFeatureEntry*)zix_hash_find(world->feature_ids, &key);
+
+  if (entry) {
+    *id = entry->id;
+  }
+
+  return entry;
+}
+
+/** Intern a feature, which must be called with the node lock held. */
+static uint32_t
+lilv_world_intern_feature_locked(LilvWorld* world, const SordNode* uri)
+{
+  uint32_t id = 0U;
+  if (lilv_world_find_feature_locked(world, uri, &id)) {
+    return id;
+  }
+
+  id = world->n_features++;
+  world->feature_uris =
+    (SordNode**)realloc(world->feature_uris, world->n_features * sizeof(void*));
+
+  world->feature_uris[id] = sord_node_copy(uri);
+
+  const LilvFeatureEntry entry = {world->feature_uris[id], id};
+  zix_hash_insert(world->feature_ids, &entry, NULL);
+  return id;
+}
+
+bool
+lilv_world_find_feature(LilvWorld* world, const SordNode* uri, uint32_t* id)
+{
+  lilv_world_lock_nodes(world);
+  const bool found = lilv_world_find_feature_locked(world, uri, id);
+  lilv_world_unlock_nodes(world);
+  return found;
+}
+
+uint32_t
+lilv_world_intern_feature(LilvWorld* world, const SordNode* uri)
+{
+  lilv_world_lock_nodes(world);
+  const uint32_t id = lilv_world_intern_feature_locked(world, uri);
+  lilv_world_unlock_nodes(world);
+  return id;
+}
+
+LilvNodes*
+lilv_world_feature_nodes(LilvWorld* world, const LilvBitset* bits)
+{
+  if (!bits->n_words) {
+    return NULL;
+  }
+
+  // Copy the feature URIs, since the table may be grown by another thread
+  lilv_world_lock_nodes(world);
+  const uint32_t   n_features = world->n_features;
+  const SordNode** uris =
+    (const SordNode**)calloc(n_features ? n_features : 1U, sizeof(void*));
+  for (uint32_t id = 0U; id < n_features; ++id) {
+    if (lilv_bitset_has(bits, id)) {
+      uris[id] = world->feature_uris[id];
+    }
+  }
+  lilv_world_unlock_nodes(world);
+
+  // Feature URI nodes are never freed before the world, so are safe to use
+  LilvNodes* const nodes = lilv_nodes_new();
+  for (uint32_t id = 0U; id < n_features; ++id) {
+    if (uris[id]) {
+      lilv_collection_insert(nodes, lilv_node_new_from_node(world, uris[id]));
+    }
+  }
+
+  free(uris);
+  return nodes;
+}
+
+/* Feature sets */
+
+bool
+lilv_plugin_is_supported(const LilvPlugin*     plugin,
+                         const LilvFeatureSet* features)
+{
+  lilv_plugin_load_if_necessary(plugin);
+
+  return lilv_bitset_is_subset(&plugin->required_features, &features->bits);
+}
+
+LilvFeatureSet*
+lilv_feature_set_new(LilvWorld* world, const LV2_Feature* const* features)
+{
+  LilvFeatureSet* const set =
+    (LilvFeatureSet*)calloc(1, sizeof(LilvFeatureSet));
+
+  set->world = world;
+
+  lilv_world_lock_nodes(world);
+  for (const LV2_Feature* const* f = features; f && *f; ++f) {
+    SordNode* const uri =
+      sord_new_uri(world->world, (const uint8_t*)(*f)->URI);
+
+    lilv_bitset_set(&set->bits, lilv_world_intern_feature_locked(world, uri));
+    sord_node_free(world->world, uri);
+  }
+  lilv_world_unlock_nodes(world);
+
+  return set;
+}
+
+void
+lilv_feature_set_add(LilvFeatureSet* set, const LilvNode* uri)
+{
+  if (lilv_node_is_uri(uri)) {
+    lilv_bitset_set(&set->bits,
+                    lilv_world_intern_feature(set->world, uri->node));
+  }
+}
+
+bool
+lilv_feature_set_contains(const LilvFeatureSet* set, const LilvNode* uri)
+{
+  uint32_t id = 0U;
+
+  return lilv_node_is_uri(uri) &&
+         lilv_world_find_feature(set->world, uri->node, &id) &&
+         lilv_bitset_has(&set->bits, id);
+}
+
+void
+lilv_feature_set_free(LilvFeatureSet* set)
+{
+  if (set) {
+    lilv_bitset_clear(&set->bits);
+    free(set);
+  }
+}
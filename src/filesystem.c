@@ -46,6 +46,7 @@
 
 #include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -471,6 +472,39 @@ lilv_create_temporary_directory(const char* pattern)
   return result;
 }
 
+FILE*
+lilv_create_temporary_file(char* path_pattern)
+{
+  const size_t path_len = strlen(path_pattern);
+  if (path_len < 6 || strcmp(path_pattern + path_len - 6, "XXXXXX")) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+#ifdef _WIN32
+  static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  static const int  n_chars = sizeof(chars) - 1;
+
+  char* const suffix = path_pattern + path_len - 6;
+  for (unsigned attempt = 0; attempt < 128; ++attempt) {
+    for (unsigned i = 0; i < 6; ++i) {
+      suffix[i] = chars[rand() % n_chars];
+    }
+
+    FILE* const file = fopen(path_pattern, "wbx");
+    if (file) {
+      return file;
+    }
+  }
+
+  return NULL;
+#else
+  const int fd = mkstemp(path_pattern);
+
+  return fd < 0 ? NULL : fdopen(fd, "wb");
+#endif
+}
+
 int
 lilv_create_directories(const char* dir_path)
 {
@@ -522,6 +556,36 @@ lilv_remove(const char* path)
   return remove(path);
 }
 
+int
+lilv_file_stamp(const char* path, uint64_t* size, int64_t* mtime)
+{
+  struct stat st;
+  if (stat(path, &st)) {
+    return errno;
+  }
+
+  *size  = (uint64_t)st.st_size;
+  *mtime = (int64_t)st.st_mtime * 1000000000;
+
+#if USE_STAT_ST_MTIM
+  *mtime += (int64_t)st.st_mtim.tv_nsec;
+#elif USE_STAT_ST_MTIMESPEC
+  *mtime += (int64_t)st.st_mtimespec.tv_nsec;
+#endif
+
+  return 0;
+}
+
+int
+lilv_replace_file(const char* src, const char* dst)
+{
+#ifdef _WIN32
+  return !MoveFileEx(src, dst, MOVEFILE_REPLACE_EXISTING);
+#else
+  return rename(src, dst);
+#endif
+}
+
 bool
 lilv_file_equals(const char* a_path, const char* b_path)
 {
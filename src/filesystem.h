@@ -15,6 +15,7 @@
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 /// Return the path to a directory suitable for making temporary files
@@ -165,6 +166,17 @@ lilv_create_temporary_directory_in(const char* pattern, const char* parent);
 char*
 lilv_create_temporary_directory(const char* pattern);
 
+/**
+   Create and open a new file for writing with a unique name.
+
+   The last six characters of `path_pattern` must be "XXXXXX", and are
+   replaced with characters that make a unique file name.
+
+   @return An open file, or null on error.
+*/
+FILE*
+lilv_create_temporary_file(char* path_pattern);
+
 /**
    Create the directory `dir_path` and any parent directories if necessary.
 
@@ -177,6 +189,25 @@ lilv_create_directories(const char* dir_path);
 int
 lilv_remove(const char* path);
 
+/**
+   Get the size and modification time of the file at `path`.
+
+   The modification time is in nanoseconds since the epoch, but only has a
+   resolution of seconds on systems without `st_mtim` or `st_mtimespec`.
+
+   @return Zero on success, or an `errno` error code.
+*/
+int
+lilv_file_stamp(const char* path, uint64_t* size, int64_t* mtime);
+
+/**
+   Move the file at `src` to `dst`, atomically replacing any existing file.
+
+   @return Zero on success, or non-zero on error.
+*/
+int
+lilv_replace_file(const char* src, const char* dst);
+
 /// Return true iff the given paths point to files with identical contents
 bool
 lilv_file_equals(const char* a_path, const char* b_path);
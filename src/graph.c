@@ -0,0 +1,531 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "lv2/atom/atom.h"
+#include "lv2/core/lv2.h"
+#include "lv2/urid/urid.h"
+#include "zix/sem.h"
+#include "zix/thread.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Alignment of port buffers, which is a typical cache line size. */
+#define LILV_GRAPH_ALIGN 64U
+
+/** Port classes that determine the type of buffer a port uses. */
+#define LILV_GRAPH_BUFFER_CLASSES                                          \
+  (LILV_PORT_CLASS_AUDIO | LILV_PORT_CLASS_CONTROL | LILV_PORT_CLASS_CV | \
+   LILV_PORT_CLASS_ATOM)
+
+typedef struct {
+  LilvInstance*        instance;       ///< Plugin instance, not owned
+  const LilvPortTable* ports;          ///< Port table of plugin
+  void**               buffers;        ///< Buffer for each port, or NULL
+  uint32_t*            atom_outputs;   ///< Indices of atom output ports
+  uint32_t             n_atom_outputs; ///< Number of atom output ports
+} LilvGraphNode;
+
+typedef struct {
+  uint32_t src_node;
+  uint32_t src_port;
+  uint32_t dst_node;
+  uint32_t dst_port;
+} LilvGraphEdge;
+
+typedef struct {
+  LilvGraph* graph;
+  unsigned   share; ///< Index of this worker's share of each level
+  ZixSem     start; ///< Posted to start running a level
+} LilvGraphWorker;
+
+struct LilvGraphImpl {
+  uint32_t         block_length;  ///< Maximum number of frames per run
+  uint32_t         atom_capacity; ///< Size of atom port buffers in bytes
+  LV2_URID         atom_Chunk;
+  LV2_URID         atom_Sequence;
+  LilvGraphNode*   nodes;
+  uint32_t         n_nodes;
+  LilvGraphEdge*   edges;
+  size_t           n_edges;
+  uint32_t*        order;      ///< Node indices in execution order
+  uint32_t*        level_ends; ///< End of each level in order
+  uint32_t         n_levels;   ///< Number of levels of independent nodes
+  void*            memory;     ///< Allocation for every port buffer
+  bool             compiled;   ///< True if ready to run
+  LilvGraphWorker* workers;
+  ZixThread*       threads;
+  unsigned         n_workers; ///< Number of running worker threads
+  ZixSem           done;      ///< Posted by workers after running a level
+  bool             exiting;   ///< True if workers should exit
+  uint32_t         begin;     ///< Start of current level in order
+  uint32_t         end;       ///< End of current level in order
+  unsigned         width;     ///< Number of threads running current level
+  uint32_t         n_frames;  ///< Number of frames in current run
+};
+
+/** Return the kind of buffer a port uses, or zero if it is unsupported. */
+static uint32_t
+lilv_graph_buffer_type(const LilvGraph* graph, uint32_t classes)
+{
+  const uint32_t type = classes & LILV_GRAPH_BUFFER_CLASSES;
+
+  if (type == LILV_PORT_CLASS_CV) {
+    return LILV_PORT_CLASS_AUDIO; // Both are arrays of float samples
+  }
+
+  if (type == LILV_PORT_CLASS_ATOM && !graph->atom_Sequence) {
+    return 0U; // Atom ports can only be supported with a URID map
+  }
+
+  return type;
+}
+
+static size_t
+lilv_graph_buffer_size(const LilvGraph* graph, uint32_t type)
+{
+  switch (type) {
+  case LILV_PORT_CLASS_AUDIO:
+    return graph->block_length * sizeof(float);
+  case LILV_PORT_CLASS_CONTROL:
+    return sizeof(float);
+  case LILV_PORT_CLASS_ATOM:
+    return graph->atom_capacity;
+  default:
+    break;
+  }
+
+  return 0U;
+}
+
+static size_t
+lilv_graph_align(size_t size)
+{
+  return (size + LILV_GRAPH_ALIGN - 1U) & ~(size_t)(LILV_GRAPH_ALIGN - 1U);
+}
+
+static const LilvGraphEdge*
+lilv_graph_find_input_edge(const LilvGraph* graph,
+                           uint32_t         node,
+                           uint32_t         port)
+{
+  for (size_t e = 0; e < graph->n_edges; ++e) {
+    if (graph->edges[e].dst_node == node && graph->edges[e].dst_port == port) {
+      return &graph->edges[e];
+    }
+  }
+
+  return NULL;
+}
+
+static void
+lilv_graph_run_node(const LilvGraph* graph, const LilvGraphNode* node)
+{
+  // Reset the size of atom outputs to the available space
+  for (uint32_t i = 0; i < node->n_atom_outputs; ++i) {
+    LV2_Atom* const atom = (LV2_Atom*)node->buffers[node->atom_outputs[i]];
+
+    atom->size = graph->atom_capacity - (uint32_t)sizeof(LV2_Atom);
+    atom->type = graph->atom_Chunk;
+  }
+
+  const LV2_Descriptor* const descriptor = node->instance->lv2_descriptor;
+
+  descriptor->run(node->instance->lv2_handle, graph->n_frames);
+}
+
+/** Run every `width`th node in the current level, starting at `share`. */
+static void
+lilv_graph_run_share(const LilvGraph* graph, unsigned share)
+{
+  for (uint32_t i = graph->begin + share; i < graph->end; i += graph->width) {
+    lilv_graph_run_node(graph, &graph->nodes[graph->order[i]]);
+  }
+}
+
+static void*
+lilv_graph_worker(void* data)
+{
+  LilvGraphWorker* const worker = (LilvGraphWorker*)data;
+  LilvGraph* const       graph  = worker->graph;
+
+  for (;;) {
+    zix_sem_wait(&worker->start);
+    if (graph->exiting) {
+      break;
+    }
+
+    lilv_graph_run_share(graph, worker->share);
+    zix_sem_post(&graph->done);
+  }
+
+  return NULL;
+}
+
+LilvGraph*
+lilv_graph_new(uint32_t      block_length,
+               uint32_t      atom_capacity,
+               LV2_URID_Map* map,
+               unsigned      n_threads)
+{
+  LilvGraph* const graph = (LilvGraph*)calloc(1, sizeof(LilvGraph));
+
+  graph->block_length = block_length;
+  graph->atom_capacity =
+    atom_capacity > sizeof(LV2_Atom_Sequence) ? atom_capacity : 0U;
+
+  if (map && graph->atom_capacity) {
+    graph->atom_Chunk    = map->map(map->handle, LV2_ATOM__Chunk);
+    graph->atom_Sequence = map->map(map->handle, LV2_ATOM__Sequence);
+  }
+
+  zix_sem_init(&graph->done, 0);
+
+  const unsigned n_workers = n_threads > 1U ? n_threads - 1U : 0U;
+  if (n_workers) {
+    graph->workers =
+      (LilvGraphWorker*)calloc(n_workers, sizeof(LilvGraphWorker));
+    graph->threads = (ZixThread*)calloc(n_workers, sizeof(ZixThread));
+
+    for (unsigned w = 0; w < n_workers; ++w) {
+      LilvGraphWorker* const worker = &graph->workers[w];
+
+      worker->graph = graph;
+      worker->share = w + 1U;
+      zix_sem_init(&worker->start, 0);
+
+      if (zix_thread_create(
+            &graph->threads[w], 0, lilv_graph_worker, worker)) {
+        zix_sem_destroy(&worker->start);
+        break; // Run with the threads that were started
+      }
+
+      ++graph->n_workers;
+    }
+  }
+
+  return graph;
+}
+
+int
+lilv_graph_add(LilvGraph*        graph,
+               const LilvPlugin* plugin,
+               LilvInstance*     instance)
+{
+  const LilvPortTable* const ports = lilv_plugin_get_port_table(plugin);
+  if (!ports || !instance) {
+    return 1;
+  }
+
+  graph->nodes = (LilvGraphNode*)realloc(
+    graph->nodes, ++graph->n_nodes * sizeof(LilvGraphNode));
+
+  LilvGraphNode* const node = &graph->nodes[graph->n_nodes - 1];
+  node->instance            = instance;
+  node->ports               = ports;
+  node->buffers             = (void**)calloc(ports->n_ports, sizeof(void*));
+  node->atom_outputs   = (uint32_t*)calloc(ports->n_ports, sizeof(uint32_t));
+  node->n_atom_outputs = 0U;
+
+  graph->compiled = false;
+  return 0;
+}
+
+int
+lilv_graph_connect(LilvGraph* graph,
+                   uint32_t   src_node,
+                   uint32_t   src_port,
+                   uint32_t   dst_node,
+                   uint32_t   dst_port)
+{
+  if (src_node >= graph->n_nodes || dst_node >= graph->n_nodes) {
+    LILV_ERROR("Graph connection to nonexistent node\n");
+    return 1;
+  }
+
+  const LilvPortTable* const src = graph->nodes[src_node].ports;
+  const LilvPortTable* const dst = graph->nodes[dst_node].ports;
+  if (src_port >= src->n_ports || dst_port >= dst->n_ports) {
+    LILV_ERROR("Graph connection to nonexistent port\n");
+    return 1;
+  }
+
+  const uint32_t src_classes = src->classes[src_port];
+  const uint32_t dst_classes = dst->classes[dst_port];
+  const uint32_t src_type    = lilv_graph_buffer_type(graph, src_classes);
+  if (!(src_classes & LILV_PORT_CLASS_OUTPUT) ||
+      !(dst_classes & LILV_PORT_CLASS_INPUT) || !src_type ||
+      src_type != lilv_graph_buffer_type(graph, dst_classes)) {
+    LILV_ERROR("Graph connection between incompatible ports\n");
+    return 1;
+  }
+
+  if (lilv_graph_find_input_edge(graph, dst_node, dst_port)) {
+    LILV_ERROR("Graph connection to input that is already connected\n");
+    return 1;
+  }
+
+  graph->edges = (LilvGraphEdge*)realloc(
+    graph->edges, ++graph->n_edges * sizeof(LilvGraphEdge));
+
+  const LilvGraphEdge edge = {src_node, src_port, dst_node, dst_port};
+
+  graph->edges[graph->n_edges - 1] = edge;
+  graph->compiled                  = false;
+  return 0;
+}
+
+/** Sort nodes into levels, where each level only depends on earlier ones. */
+static int
+lilv_graph_sort(LilvGraph* graph)
+{
+  uint32_t* const in_degree =
+    (uint32_t*)calloc(graph->n_nodes + 1U, sizeof(uint32_t));
+
+  for (size_t e = 0; e < graph->n_edges; ++e) {
+    ++in_degree[graph->edges[e].dst_node];
+  }
+
+  uint32_t n_sorted = 0U;
+  for (uint32_t n = 0; n < graph->n_nodes; ++n) {
+    if (!in_degree[n]) {
+      graph->order[n_sorted++] = n;
+    }
+  }
+
+  // Each level is the nodes whose last dependency is in the previous level
+  graph->n_levels = 0U;
+  for (uint32_t begin = 0U; begin < n_sorted;) {
+    const uint32_t end = n_sorted;
+
+    graph->level_ends[graph->n_levels++] = end;
+    for (uint32_t i = begin; i < end; ++i) {
+      for (size_t e = 0; e < graph->n_edges; ++e) {
+        const LilvGraphEdge* const edge = &graph->edges[e];
+        if (edge->src_node == graph->order[i] && !--in_degree[edge->dst_node]) {
+          graph->order[n_sorted++] = edge->dst_node;
+        }
+      }
+    }
+
+    begin = end;
+  }
+
+  free(in_degree);
+
+  if (n_sorted < graph->n_nodes) {
+    LILV_ERROR("Graph contains a cycle\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+/** Allocate port buffers and connect every port of every node. */
+static int
+lilv_graph_connect_buffers(LilvGraph* graph)
+{
+  // Find the total size of buffers for outputs and unconnected inputs
+  size_t total_size = 0U;
+  for (uint32_t n = 0; n < graph->n_nodes; ++n) {
+    const LilvPortTable* const ports = graph->nodes[n].ports;
+    for (uint32_t p = 0; p < ports->n_ports; ++p) {
+      const uint32_t type = lilv_graph_buffer_type(graph, ports->classes[p]);
+      if ((ports->classes[p] & LILV_PORT_CLASS_OUTPUT) ||
+          !lilv_graph_find_input_edge(graph, n, p)) {
+        total_size += lilv_graph_align(lilv_graph_buffer_size(graph, type));
+      }
+    }
+  }
+
+  free(graph->memory);
+  graph->memory = calloc(1U, total_size + LILV_GRAPH_ALIGN);
+
+  const uintptr_t misalignment = (uintptr_t)graph->memory % LILV_GRAPH_ALIGN;
+
+  uint8_t* buf = (uint8_t*)graph->memory +
+                 (misalignment ? LILV_GRAPH_ALIGN - misalignment : 0U);
+
+  // Assign a buffer to every output and unconnected input
+  for (uint32_t n = 0; n < graph->n_nodes; ++n) {
+    LilvGraphNode* const       node  = &graph->nodes[n];
+    const LilvPortTable* const ports = node->ports;
+
+    node->n_atom_outputs = 0U;
+    for (uint32_t p = 0; p < ports->n_ports; ++p) {
+      const uint32_t classes = ports->classes[p];
+      const uint32_t type    = lilv_graph_buffer_type(graph, classes);
+      const bool     output  = classes & LILV_PORT_CLASS_OUTPUT;
+      if (!output && lilv_graph_find_input_edge(graph, n, p)) {
+        continue; // Connected input, assigned below
+      }
+
+      const size_t size = lilv_graph_buffer_size(graph, type);
+
+      node->buffers[p] = size ? buf : NULL;
+      buf += lilv_graph_align(size);
+
+      if (type == LILV_PORT_CLASS_CONTROL && !output &&
+          !isnan(ports->defaults[p])) {
+        *(float*)node->buffers[p] = ports->defaults[p];
+      } else if (type == LILV_PORT_CLASS_ATOM && output) {
+        node->atom_outputs[node->n_atom_outputs++] = p;
+      } else if (type == LILV_PORT_CLASS_ATOM) {
+        LV2_Atom_Sequence* const seq = (LV2_Atom_Sequence*)node->buffers[p];
+
+        seq->atom.size = sizeof(LV2_Atom_Sequence_Body);
+        seq->atom.type = graph->atom_Sequence;
+      }
+    }
+  }
+
+  // Connected inputs share the buffer of the output they are connected to
+  for (size_t e = 0; e < graph->n_edges; ++e) {
+    const LilvGraphEdge* const edge = &graph->edges[e];
+
+    graph->nodes[edge->dst_node].buffers[edge->dst_port] =
+      graph->nodes[edge->src_node].buffers[edge->src_port];
+  }
+
+  // Connect every port, failing if a required port can not be supported
+  int st = 0;
+  for (uint32_t n = 0; n < graph->n_nodes; ++n) {
+    const LilvGraphNode* const  node       = &graph->nodes[n];
+    const LilvPortTable* const  ports      = node->ports;
+    const LV2_Descriptor* const descriptor = node->instance->lv2_descriptor;
+
+    for (uint32_t p = 0; p < ports->n_ports; ++p) {
+      if (!node->buffers[p] &&
+          !(ports->properties[p] & LILV_PORT_PROP_CONNECTION_OPTIONAL)) {
+        LILV_ERRORF("Graph can not connect port `%s' of <%s>\n",
+                    lilv_node_as_string(ports->symbols[p]),
+                    descriptor->URI);
+        st = 1;
+      }
+
+      descriptor->connect_port(
+        node->instance->lv2_handle, p, node->buffers[p]);
+    }
+  }
+
+  return st;
+}
+
+int
+lilv_graph_compile(LilvGraph* graph)
+{
+  graph->compiled = false;
+
+  free(graph->order);
+  free(graph->level_ends);
+  graph->order = (uint32_t*)calloc(graph->n_nodes + 1U, sizeof(uint32_t));
+  graph->level_ends =
+    (uint32_t*)calloc(graph->n_nodes + 1U, sizeof(uint32_t));
+
+  if (lilv_graph_sort(graph) || lilv_graph_connect_buffers(graph)) {
+    return 1;
+  }
+
+  graph->compiled = true;
+  return 0;
+}
+
+const uint32_t*
+lilv_graph_get_order(const LilvGraph* graph)
+{
+  return graph->compiled ? graph->order : NULL;
+}
+
+void*
+lilv_graph_get_buffer(const LilvGraph* graph, uint32_t node, uint32_t port)
+{
+  if (!graph->compiled || node >= graph->n_nodes ||
+      port >= graph->nodes[node].ports->n_ports) {
+    return NULL;
+  }
+
+  return graph->nodes[node].buffers[port];
+}
+
+void
+lilv_graph_run(LilvGraph* graph, uint32_t n_frames)
+{
+  if (!graph->compiled || n_frames > graph->block_length) {
+    return;
+  }
+
+  graph->n_frames = n_frames;
+  for (uint32_t l = 0; l < graph->n_levels; ++l) {
+    graph->begin = l ? graph->level_ends[l - 1] : 0U;
+    graph->end   = graph->level_ends[l];
+
+    // Split the level between this thread and as many workers as useful
+    const uint32_t n_level_nodes = graph->end - graph->begin;
+    graph->width = n_level_nodes < graph->n_workers + 1U
+                     ? n_level_nodes
+                     : graph->n_workers + 1U;
+
+    for (unsigned w = 0; w + 1U < graph->width; ++w) {
+      zix_sem_post(&graph->workers[w].start);
+    }
+
+    lilv_graph_run_share(graph, 0U);
+
+    for (unsigned w = 0; w + 1U < graph->width; ++w) {
+      zix_sem_wait(&graph->done);
+    }
+  }
+}
+
+void
+lilv_graph_free(LilvGraph* graph)
+{
+  if (!graph) {
+    return;
+  }
+
+  graph->exiting = true;
+  for (unsigned w = 0; w < graph->n_workers; ++w) {
+    zix_sem_post(&graph->workers[w].start);
+  }
+
+  for (unsigned w = 0; w < graph->n_workers; ++w) {
+    zix_thread_join(graph->threads[w], NULL);
+    zix_sem_destroy(&graph->workers[w].start);
+  }
+
+  for (uint32_t n = 0; n < graph->n_nodes; ++n) {
+    free(graph->nodes[n].atom_outputs);
+    free(graph->nodes[n].buffers);
+  }
+
+  zix_sem_destroy(&graph->done);
+  free(graph->memory);
+  free(graph->level_ends);
+  free(graph->order);
+  free(graph->edges);
+  free(graph->nodes);
+  free(graph->threads);
+  free(graph->workers);
+  free(graph);
+}
@@ -19,37 +19,75 @@
 #include "lilv/lilv.h"
 #include "lv2/core/lv2.h"
 #include "serd/serd.h"
+#include "zix/sem.h"
+#include "zix/thread.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
-LilvInstance*
-lilv_plugin_instantiate(const LilvPlugin*         plugin,
-                        double                    sample_rate,
-                        const LV2_Feature* const* features)
+struct LilvInstancePoolImpl {
+  const LilvPlugin*         plugin;
+  double                    sample_rate;
+  const LV2_Feature* const* features;
+  LilvInstance**            instances;   ///< Stack of available instances
+  unsigned                  n_instances; ///< Number of instances to create
+  unsigned                  n_available; ///< Number of instances on stack
+  ZixSem                    lock;        ///< Lock for the stack
+  ZixThread                 thread;      ///< Thread creating instances
+  LilvLib*                  lib;         ///< Library reference held by pool
+  bool                      filling;     ///< True if thread must be joined
+};
+
+/** Open the library of a plugin for instantiation. */
+static LilvInstantiateStatus
+lilv_plugin_open_library(const LilvPlugin*         plugin,
+                         const LV2_Feature* const* features,
+                         LilvLib**                 lib)
 {
   lilv_plugin_load_if_necessary(plugin);
   if (plugin->parse_errors) {
-    return NULL;
+    return LILV_INSTANTIATE_BAD_DATA;
   }
 
-  LilvInstance*         result     = NULL;
   const LilvNode* const lib_uri    = lilv_plugin_get_library_uri(plugin);
   const LilvNode* const bundle_uri = lilv_plugin_get_bundle_uri(plugin);
   if (!lib_uri || !bundle_uri) {
-    return NULL;
+    return LILV_INSTANTIATE_BAD_DATA;
   }
 
   char* const bundle_path =
     lilv_file_uri_parse(lilv_node_as_uri(bundle_uri), NULL);
 
-  LilvLib* lib = lilv_lib_open(plugin->world, lib_uri, bundle_path, features);
-  if (!lib) {
-    serd_free(bundle_path);
-    return NULL;
+  *lib = lilv_lib_open(plugin->world, lib_uri, bundle_path, features);
+  serd_free(bundle_path);
+
+  return *lib ? LILV_INSTANTIATE_SUCCESS : LILV_INSTANTIATE_NO_LIBRARY;
+}
+
+/**
+   Instantiate a plugin from its open library.
+
+   This does not modify the world.  On success, the new instance takes the
+   reference to `lib`, otherwise the caller must close it.
+*/
+static LilvInstantiateStatus
+lilv_lib_instantiate(LilvLib*                  lib,
+                     const LilvPlugin*         plugin,
+                     double                    sample_rate,
+                     const LV2_Feature* const* features,
+                     LilvInstance**            instance)
+{
+  // Find plugin by URI
+  const LV2_Descriptor* const ld = lilv_lib_get_plugin_by_uri(
+    lib, lilv_node_as_uri(lilv_plugin_get_uri(plugin)));
+  if (!ld) {
+    LILV_ERRORF("No plugin <%s> in <%s>\n",
+                lilv_node_as_uri(lilv_plugin_get_uri(plugin)),
+                lilv_node_as_uri(lilv_plugin_get_library_uri(plugin)));
+    return LILV_INSTANTIATE_NO_PLUGIN;
   }
 
   const LV2_Feature** local_features = NULL;
@@ -58,46 +96,51 @@ lilv_plugin_instantiate(const LilvPlugin*         plugin,
     local_features[0] = NULL;
   }
 
-  // Search for plugin by URI
-  for (uint32_t i = 0; true; ++i) {
-    const LV2_Descriptor* ld = lilv_lib_get_plugin(lib, i);
-    if (!ld) {
-      LILV_ERRORF("No plugin <%s> in <%s>\n",
-                  lilv_node_as_uri(lilv_plugin_get_uri(plugin)),
-                  lilv_node_as_uri(lib_uri));
-      lilv_lib_close(lib);
-      break; // return NULL
-    }
+  char* const bundle_path = lilv_file_uri_parse(
+    lilv_node_as_uri(lilv_plugin_get_bundle_uri(plugin)), NULL);
 
-    if (!strcmp(ld->URI, lilv_node_as_uri(lilv_plugin_get_uri(plugin)))) {
-      // Create LilvInstance to return
-      result                 = (LilvInstance*)malloc(sizeof(LilvInstance));
-      result->lv2_descriptor = ld;
-      result->lv2_handle     = ld->instantiate(
-        ld, sample_rate, bundle_path, (features) ? features : local_features);
-      result->pimpl = lib;
-      break;
-    }
-  }
+  // Create LilvInstance to return
+  LilvInstance* const result = (LilvInstance*)malloc(sizeof(LilvInstance));
+  result->lv2_descriptor     = ld;
+  result->lv2_handle         = ld->instantiate(
+    ld, sample_rate, bundle_path, (features) ? features : local_features);
+  result->pimpl = lib;
 
   free(local_features);
   serd_free(bundle_path);
 
-  if (result) {
-    if (result->lv2_handle == NULL) {
-      // Failed to instantiate
-      free(result);
-      lilv_lib_close(lib);
-      return NULL;
-    }
+  if (result->lv2_handle == NULL) {
+    // Failed to instantiate
+    free(result);
+    return LILV_INSTANTIATE_FAILED;
+  }
 
-    // "Connect" all ports to NULL (catches bugs)
-    for (uint32_t i = 0; i < lilv_plugin_get_num_ports(plugin); ++i) {
-      result->lv2_descriptor->connect_port(result->lv2_handle, i, NULL);
-    }
+  // "Connect" all ports to NULL (catches bugs)
+  const uint32_t n_ports = lilv_plugin_get_num_ports(plugin);
+  for (uint32_t i = 0; i < n_ports; ++i) {
+    result->lv2_descriptor->connect_port(result->lv2_handle, i, NULL);
+  }
+
+  *instance = result;
+  return LILV_INSTANTIATE_SUCCESS;
+}
+
+LilvInstance*
+lilv_plugin_instantiate(const LilvPlugin*         plugin,
+                        double                    sample_rate,
+                        const LV2_Feature* const* features)
+{
+  LILV_TRACE_BEGIN(plugin->world, lilv_node_as_string(plugin->plugin_uri));
+
+  LilvInstance* instance = NULL;
+  LilvLib*      lib      = NULL;
+  if (!lilv_plugin_open_library(plugin, features, &lib) &&
+      lilv_lib_instantiate(lib, plugin, sample_rate, features, &instance)) {
+    lilv_lib_close(lib);
   }
 
-  return result;
+  LILV_TRACE_END();
+  return instance;
 }
 
 void
@@ -113,3 +156,297 @@ lilv_instance_free(LilvInstance* instance)
   instance->pimpl = NULL;
   free(instance);
 }
+
+/** A request in a batch, which holds a reference to its library. */
+typedef struct {
+  LilvLib* lib;   ///< Open library of plugin
+  size_t   index; ///< Index of request
+} LilvInstantiateEntry;
+
+/** A batch of requests shared by instantiation workers. */
+typedef struct {
+  LilvInstantiateRequest* requests;
+  LilvInstantiateEntry*   entries;   ///< Entries sorted by library
+  size_t                  n_entries; ///< Number of entries
+  size_t                  next;      ///< Index of next entry to claim
+  ZixSem                  lock;      ///< Lock for next
+} LilvInstantiateBatch;
+
+static int
+lilv_instantiate_entry_compare(const void* a, const void* b)
+{
+  const LilvInstantiateEntry* const entry_a = (const LilvInstantiateEntry*)a;
+  const LilvInstantiateEntry* const entry_b = (const LilvInstantiateEntry*)b;
+  const uintptr_t                   lib_a   = (uintptr_t)entry_a->lib;
+  const uintptr_t                   lib_b   = (uintptr_t)entry_b->lib;
+
+  if (lib_a != lib_b) {
+    return lib_a < lib_b ? -1 : 1;
+  }
+
+  return entry_a->index < entry_b->index ? -1 : 1;
+}
+
+/** Instantiate the requests for one library at a time until none are left. */
+static void*
+lilv_instantiate_worker(void* data)
+{
+  LilvInstantiateBatch* const batch = (LilvInstantiateBatch*)data;
+
+  for (;;) {
+    // Claim every entry for the next library
+    zix_sem_wait(&batch->lock);
+    const size_t begin = batch->next;
+    size_t       end   = begin;
+    while (end < batch->n_entries &&
+           batch->entries[end].lib == batch->entries[begin].lib) {
+      ++end;
+    }
+    batch->next = end;
+    zix_sem_post(&batch->lock);
+
+    if (begin == end) {
+      break;
+    }
+
+    for (size_t e = begin; e < end; ++e) {
+      LilvInstantiateRequest* const request =
+        &batch->requests[batch->entries[e].index];
+
+      const LilvPlugin* const plugin = request->plugin;
+
+      LILV_TRACE_BEGIN(plugin->world, lilv_node_as_string(plugin->plugin_uri));
+      request->status = lilv_lib_instantiate(batch->entries[e].lib,
+                                             plugin,
+                                             request->sample_rate,
+                                             request->features,
+                                             &request->instance);
+      LILV_TRACE_END();
+    }
+  }
+
+  return NULL;
+}
+
+unsigned
+lilv_world_instantiate(LilvWorld*              world,
+                       LilvInstantiateRequest* requests,
+                       size_t                  n_requests,
+                       unsigned                n_threads)
+{
+  LilvLibRequest* const lib_requests = (LilvLibRequest*)calloc(
+    n_requests ? n_requests : 1U, sizeof(LilvLibRequest));
+
+  // Load plugin data and ports, so the workers only read the world
+  size_t n_libs = 0U;
+  for (size_t r = 0; r < n_requests; ++r) {
+    LilvInstantiateRequest* const request = &requests[r];
+    const LilvPlugin* const       plugin  = request->plugin;
+
+    request->instance = NULL;
+    request->status   = LILV_INSTANTIATE_BAD_DATA;
+
+    lilv_plugin_load_if_necessary(plugin);
+    if (!plugin->parse_errors && lilv_plugin_get_library_uri(plugin)) {
+      lilv_plugin_get_num_ports(plugin);
+      request->status = LILV_INSTANTIATE_NO_LIBRARY; // Until it is opened
+      lib_requests[n_libs].plugin   = plugin;
+      lib_requests[n_libs].features = request->features;
+      ++n_libs;
+    }
+  }
+
+  // Open every library, loading them in parallel
+  lilv_lib_open_all(world, lib_requests, n_libs, n_threads);
+
+  LilvInstantiateBatch batch;
+  batch.requests  = requests;
+  batch.n_entries = 0U;
+  batch.next      = 0U;
+  batch.entries =
+    (LilvInstantiateEntry*)calloc(n_libs ? n_libs : 1U, sizeof(*batch.entries));
+
+  for (size_t r = 0, l = 0; r < n_requests; ++r) {
+    if (requests[r].status == LILV_INSTANTIATE_NO_LIBRARY) {
+      LilvLib* const lib = lib_requests[l++].lib;
+      if (lib) {
+        batch.entries[batch.n_entries].lib   = lib;
+        batch.entries[batch.n_entries].index = r;
+        ++batch.n_entries;
+      }
+    }
+  }
+
+  free(lib_requests);
+
+  // Group requests by library, each of which is handled by a single worker
+  qsort(batch.entries,
+        batch.n_entries,
+        sizeof(LilvInstantiateEntry),
+        lilv_instantiate_entry_compare);
+
+  size_t n_groups = 0U;
+  for (size_t e = 0; e < batch.n_entries; ++e) {
+    if (!e || batch.entries[e].lib != batch.entries[e - 1].lib) {
+      ++n_groups;
+    }
+  }
+
+  if (n_threads < 1) {
+    n_threads = 1;
+  } else if (n_threads > n_groups) {
+    n_threads = n_groups ? (unsigned)n_groups : 1u;
+  }
+
+  zix_sem_init(&batch.lock, 1);
+
+  // Launch workers, using this thread for the first one
+  ZixThread* threads = (ZixThread*)calloc(n_threads, sizeof(ZixThread));
+  bool*      started = (bool*)calloc(n_threads, sizeof(bool));
+  for (unsigned t = 1; t < n_threads; ++t) {
+    started[t] =
+      !zix_thread_create(&threads[t], 0, lilv_instantiate_worker, &batch);
+  }
+
+  lilv_instantiate_worker(&batch);
+
+  for (unsigned t = 1; t < n_threads; ++t) {
+    if (started[t]) {
+      zix_thread_join(threads[t], NULL);
+    }
+  }
+
+  zix_sem_destroy(&batch.lock);
+  free(started);
+  free(threads);
+
+  // Close the library references that were not taken by new instances
+  unsigned n_instances = 0U;
+  for (size_t e = 0; e < batch.n_entries; ++e) {
+    if (requests[batch.entries[e].index].status) {
+      lilv_lib_close(batch.entries[e].lib);
+    } else {
+      ++n_instances;
+    }
+  }
+
+  free(batch.entries);
+
+  return n_instances;
+}
+
+/** Create every instance in a pool, possibly in a background thread. */
+static void*
+lilv_instance_pool_fill(void* data)
+{
+  LilvInstancePool* const pool = (LilvInstancePool*)data;
+
+  for (unsigned i = 0; i < pool->n_instances; ++i) {
+    LilvInstance* const instance = lilv_plugin_instantiate(
+      pool->plugin, pool->sample_rate, pool->features);
+    if (!instance) {
+      break;
+    }
+
+    zix_sem_wait(&pool->lock);
+    pool->instances[pool->n_available++] = instance;
+    zix_sem_post(&pool->lock);
+  }
+
+  return NULL;
+}
+
+LilvInstancePool*
+lilv_instance_pool_new(const LilvPlugin*         plugin,
+                       double                    sample_rate,
+                       const LV2_Feature* const* features,
+                       unsigned                  n_instances)
+{
+  LilvInstancePool* const pool =
+    (LilvInstancePool*)calloc(1, sizeof(LilvInstancePool));
+
+  pool->plugin      = plugin;
+  pool->sample_rate = sample_rate;
+  pool->features    = features;
+  pool->n_instances = n_instances;
+  pool->instances =
+    (LilvInstance**)calloc(n_instances ? n_instances : 1U, sizeof(void*));
+
+  zix_sem_init(&pool->lock, 1);
+
+  // Load everything instantiation needs, so the thread only reads the world
+  LilvLibRequest request = {plugin, features, NULL};
+  lilv_plugin_get_num_ports(plugin);
+  lilv_lib_open_all(plugin->world, &request, 1U, 1U);
+  pool->lib = request.lib;
+  if (!pool->lib) {
+    return pool;
+  }
+
+  pool->filling = !zix_thread_create(
+    &pool->thread, 0, lilv_instance_pool_fill, pool);
+
+  if (!pool->filling) {
+    lilv_instance_pool_fill(pool); // Failed to launch thread, fill here
+  }
+
+  return pool;
+}
+
+unsigned
+lilv_instance_pool_wait(LilvInstancePool* pool)
+{
+  if (pool->filling) {
+    zix_thread_join(pool->thread, NULL);
+    pool->filling = false;
+  }
+
+  return pool->n_available;
+}
+
+LilvInstance*
+lilv_instance_pool_acquire(LilvInstancePool* pool)
+{
+  LilvInstance* instance = NULL;
+
+  zix_sem_wait(&pool->lock);
+  if (pool->n_available) {
+    instance = pool->instances[--pool->n_available];
+  }
+  zix_sem_post(&pool->lock);
+
+  return instance;
+}
+
+void
+lilv_instance_pool_release(LilvInstancePool* pool, LilvInstance* instance)
+{
+  zix_sem_wait(&pool->lock);
+  if (pool->n_available < pool->n_instances) {
+    pool->instances[pool->n_available++] = instance;
+    instance = NULL;
+  }
+  zix_sem_post(&pool->lock);
+
+  lilv_instance_free(instance); // Pool is already full
+}
+
+void
+lilv_instance_pool_free(LilvInstancePool* pool)
+{
+  if (pool) {
+    lilv_instance_pool_wait(pool);
+
+    for (unsigned i = 0; i < pool->n_available; ++i) {
+      lilv_instance_free(pool->instances[i]);
+    }
+
+    if (pool->lib) {
+      lilv_lib_close(pool->lib);
+    }
+
+    zix_sem_destroy(&pool->lock);
+    free(pool->instances);
+    free(pool);
+  }
+}
@@ -19,27 +19,87 @@
 #include "lilv/lilv.h"
 #include "lv2/core/lv2.h"
 #include "serd/serd.h"
+#include "zix/common.h"
+#include "zix/hash.h"
+#include "zix/thread.h"
 #include "zix/tree.h"
 
 #ifndef _WIN32
 #  include <dlfcn.h>
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
-LilvLib*
-lilv_lib_open(LilvWorld*                world,
-              const LilvNode*           uri,
-              const char*               bundle_path,
-              const LV2_Feature* const* features)
+/** An entry in the descriptor index of a library. */
+typedef struct {
+  const char*           uri;        ///< Plugin URI, owned by the descriptor
+  const LV2_Descriptor* descriptor; ///< Plugin descriptor
+} LilvDescriptorEntry;
+
+static uint32_t
+lilv_descriptor_entry_hash(const void* value)
+{
+  const char* const uri = ((const LilvDescriptorEntry*)value)->uri;
+
+  return (uint32_t)lilv_hash_bytes(uri, strlen(uri));
+}
+
+static bool
+lilv_descriptor_entry_equals(const void* a, const void* b)
+{
+  return !strcmp(((const LilvDescriptorEntry*)a)->uri,
+                 ((const LilvDescriptorEntry*)b)->uri);
+}
+
+/** Index every plugin descriptor in `lib` by URI. */
+static ZixHash*
+lilv_lib_index_descriptors(LilvLib* lib)
+{
+  ZixHash* const index = zix_hash_new(lilv_descriptor_entry_hash,
+                                      lilv_descriptor_entry_equals,
+                                      sizeof(LilvDescriptorEntry));
+
+  const LV2_Descriptor* desc = NULL;
+  for (uint32_t i = 0; (desc = lilv_lib_get_plugin(lib, i)); ++i) {
+    if (desc->URI) {
+      // Like a linear search, the first descriptor with a URI wins
+      const LilvDescriptorEntry entry = {desc->URI, desc};
+      zix_hash_insert(index, &entry, NULL);
+    }
+  }
+
+  return index;
+}
+
+/** Open a library, which must be called with the library lock held. */
+static LilvLib*
+lilv_lib_open_locked(LilvWorld*                world,
+                     const LilvNode*           uri,
+                     const char*               bundle_path,
+                     const LV2_Feature* const* features)
 {
   ZixTreeIter*  i   = NULL;
   const LilvLib key = {
-    world, (LilvNode*)uri, (char*)bundle_path, NULL, NULL, NULL, 0};
+    world, (LilvNode*)uri, (char*)bundle_path, NULL, NULL, NULL, NULL, 0};
   if (!zix_tree_find(world->libs, &key, &i)) {
     LilvLib* llib = (LilvLib*)zix_tree_get(i);
-    ++llib->refs;
+    if (!llib->refs++) {
+      // Revive idle library that was kept open
+      for (size_t l = 0; l < world->n_idle_libs; ++l) {
+        if (world->idle_libs[l] == llib) {
+          --world->n_idle_libs;
+          memmove(world->idle_libs + l,
+                  world->idle_libs + l + 1,
+                  (world->n_idle_libs - l) * sizeof(LilvLib*));
+          break;
+        }
+      }
+    }
+
     return llib;
   }
 
@@ -50,11 +110,14 @@ lilv_lib_open(LilvWorld*                world,
     return NULL;
   }
 
+  LILV_TRACE_BEGIN(world, lib_uri);
+
   dlerror();
   void* lib = dlopen(lib_path, RTLD_NOW);
   if (!lib) {
     LILV_ERRORF("Failed to open library %s (%s)\n", lib_path, dlerror());
     serd_free(lib_path);
+    LILV_TRACE_END();
     return NULL;
   }
 
@@ -71,6 +134,7 @@ lilv_lib_open(LilvWorld*                world,
       LILV_ERRORF("Call to %s:lv2_lib_descriptor failed\n", lib_path);
       dlclose(lib);
       serd_free(lib_path);
+      LILV_TRACE_END();
       return NULL;
     }
   } else if (!df) {
@@ -78,6 +142,7 @@ lilv_lib_open(LilvWorld*                world,
                 lib_path);
     dlclose(lib);
     serd_free(lib_path);
+    LILV_TRACE_END();
     return NULL;
   }
   serd_free(lib_path);
@@ -90,11 +155,25 @@ lilv_lib_open(LilvWorld*                world,
   llib->lv2_descriptor = df;
   llib->desc           = desc;
   llib->refs           = 1;
+  llib->descriptors    = lilv_lib_index_descriptors(llib);
 
   zix_tree_insert(world->libs, llib, NULL);
+  LILV_TRACE_END();
   return llib;
 }
 
+LilvLib*
+lilv_lib_open(LilvWorld*                world,
+              const LilvNode*           uri,
+              const char*               bundle_path,
+              const LV2_Feature* const* features)
+{
+  zix_sem_wait(&world->libs_lock);
+  LilvLib* const lib = lilv_lib_open_locked(world, uri, bundle_path, features);
+  zix_sem_post(&world->libs_lock);
+  return lib;
+}
+
 const LV2_Descriptor*
 lilv_lib_get_plugin(LilvLib* lib, uint32_t index)
 {
@@ -109,19 +188,295 @@ lilv_lib_get_plugin(LilvLib* lib, uint32_t index)
   return NULL;
 }
 
+const LV2_Descriptor*
+lilv_lib_get_plugin_by_uri(const LilvLib* lib, const char* uri)
+{
+  const LilvDescriptorEntry        key   = {uri, NULL};
+  const LilvDescriptorEntry* const entry =
+    (const LilvDescriptorEntry*)zix_hash_find(lib->descriptors, &key);
+
+  return entry ? entry->descriptor : NULL;
+}
+
+/** Unload an unreferenced library, which must be called with the lock held. */
+static void
+lilv_lib_unload(LilvLib* lib)
+{
+  zix_hash_free(lib->descriptors); // Before the URIs it refers to are gone
+  dlclose(lib->lib);
+
+  ZixTreeIter* i = NULL;
+  if (lib->world->libs && !zix_tree_find(lib->world->libs, lib, &i)) {
+    zix_tree_remove(lib->world->libs, i);
+  }
+
+  lilv_node_free(lib->uri);
+  free(lib->bundle_path);
+  free(lib);
+}
+
+/** Close the oldest idle libraries, which must be called with the lock held. */
+static unsigned
+lilv_lib_trim_locked(LilvWorld* world, size_t n)
+{
+  unsigned n_closed = 0U;
+  if (world->n_idle_libs > n) {
+    const size_t n_excess = world->n_idle_libs - n;
+    for (size_t l = 0; l < n_excess; ++l) {
+      lilv_lib_unload(world->idle_libs[l]);
+      ++n_closed;
+    }
+
+    world->n_idle_libs = n;
+    memmove(world->idle_libs,
+            world->idle_libs + n_excess,
+            n * sizeof(LilvLib*));
+  }
+
+  return n_closed;
+}
+
+/** Drop a reference to a library, which must be called with the lock held. */
+static unsigned
+lilv_lib_close_locked(LilvLib* lib)
+{
+  LilvWorld* const world = lib->world;
+
+  if (--lib->refs == 0) {
+    if (world->opt.keep_libraries) {
+      // Keep library open in case it is used again soon
+      world->idle_libs = (LilvLib**)realloc(
+        world->idle_libs, ++world->n_idle_libs * sizeof(LilvLib*));
+
+      world->idle_libs[world->n_idle_libs - 1] = lib;
+      return lilv_lib_trim_locked(world, world->opt.keep_libraries);
+    }
+
+    lilv_lib_unload(lib);
+    return 1U;
+  }
+
+  return 0U;
+}
+
 void
 lilv_lib_close(LilvLib* lib)
 {
-  if (--lib->refs == 0) {
-    dlclose(lib->lib);
+  LilvWorld* const world = lib->world;
+
+  zix_sem_wait(&world->libs_lock);
+  lilv_lib_close_locked(lib);
+  zix_sem_post(&world->libs_lock);
+}
+
+unsigned
+lilv_lib_trim(LilvWorld* world, size_t n)
+{
+  zix_sem_wait(&world->libs_lock);
+  const unsigned n_closed = lilv_lib_trim_locked(world, n);
+  zix_sem_post(&world->libs_lock);
+  return n_closed;
+}
+
+/** A library to load in a worker thread for lilv_lib_open_all(). */
+typedef struct {
+  char* lib_path; ///< Path of library file
+  void* handle;   ///< Handle opened by worker, or NULL
+} LilvLibLoadJob;
 
-    ZixTreeIter* i = NULL;
-    if (lib->world->libs && !zix_tree_find(lib->world->libs, lib, &i)) {
-      zix_tree_remove(lib->world->libs, i);
+typedef struct {
+  LilvLibLoadJob* jobs;
+  size_t          n_jobs;
+  unsigned        index;
+  unsigned        n_threads;
+} LilvLibLoadWorker;
+
+/** Load every library assigned to a worker (every n_threads'th job). */
+static void*
+lib_load_worker(void* data)
+{
+  const LilvLibLoadWorker* const worker = (const LilvLibLoadWorker*)data;
+
+  for (size_t i = worker->index; i < worker->n_jobs; i += worker->n_threads) {
+    LilvLibLoadJob* const job = &worker->jobs[i];
+
+    job->handle = dlopen(job->lib_path, RTLD_NOW);
+  }
+
+  return NULL;
+}
+
+/** Load libraries with up to `n_threads` threads. */
+static void
+lilv_lib_load_jobs(LilvLibLoadJob* jobs, size_t n_jobs, unsigned n_threads)
+{
+  if (n_threads < 1) {
+    n_threads = 1;
+  } else if (n_threads > n_jobs) {
+    n_threads = n_jobs ? (unsigned)n_jobs : 1u;
+  }
+
+  LilvLibLoadWorker* workers =
+    (LilvLibLoadWorker*)calloc(n_threads, sizeof(LilvLibLoadWorker));
+  ZixThread* threads = (ZixThread*)calloc(n_threads, sizeof(ZixThread));
+  bool*      started = (bool*)calloc(n_threads, sizeof(bool));
+
+  for (unsigned t = 0; t < n_threads; ++t) {
+    workers[t].jobs      = jobs;
+    workers[t].n_jobs    = n_jobs;
+    workers[t].index     = t;
+    workers[t].n_threads = n_threads;
+  }
+
+  // Launch workers, using this thread for the first one
+  for (unsigned t = 1; t < n_threads; ++t) {
+    started[t] =
+      !zix_thread_create(&threads[t], 0, lib_load_worker, &workers[t]);
+  }
+
+  lib_load_worker(&workers[0]);
+
+  for (unsigned t = 1; t < n_threads; ++t) {
+    if (started[t]) {
+      zix_thread_join(threads[t], NULL);
+    } else {
+      lib_load_worker(&workers[t]); // Failed to launch thread, run here
+    }
+  }
+
+  free(started);
+  free(threads);
+  free(workers);
+}
+
+void
+lilv_lib_open_all(LilvWorld*      world,
+                  LilvLibRequest* requests,
+                  size_t          n_requests,
+                  unsigned        n_threads)
+{
+  // Collect distinct library paths (this loads plugin data, so is serial)
+  LilvLibLoadJob* jobs   = NULL;
+  size_t          n_jobs = 0U;
+  for (size_t r = 0; r < n_requests; ++r) {
+    const LilvNode* const lib_uri =
+      lilv_plugin_get_library_uri(requests[r].plugin);
+    if (!lib_uri) {
+      continue;
+    }
+
+    char* const lib_path =
+      lilv_file_uri_parse(lilv_node_as_uri(lib_uri), NULL);
+
+    bool found = !lib_path;
+    for (size_t j = 0; j < n_jobs && !found; ++j) {
+      found = !strcmp(jobs[j].lib_path, lib_path);
+    }
+
+    if (found) {
+      serd_free(lib_path);
+    } else {
+      jobs = (LilvLibLoadJob*)realloc(jobs, ++n_jobs * sizeof(LilvLibLoadJob));
+      jobs[n_jobs - 1].lib_path = lib_path;
+      jobs[n_jobs - 1].handle   = NULL;
+    }
+  }
+
+  // Load libraries in parallel, which does the expensive linking up front
+  lilv_lib_load_jobs(jobs, n_jobs, n_threads);
+
+  // Register the libraries, which is now cheap since they are loaded
+  for (size_t r = 0; r < n_requests; ++r) {
+    LilvLibRequest* const   request = &requests[r];
+    const LilvPlugin* const plugin  = request->plugin;
+    const LilvNode* const   lib_uri = lilv_plugin_get_library_uri(plugin);
+
+    request->lib = NULL;
+    if (lib_uri) {
+      const LilvNode* const bundle_uri = lilv_plugin_get_bundle_uri(plugin);
+      char* const           bundle_path =
+        lilv_file_uri_parse(lilv_node_as_uri(bundle_uri), NULL);
+
+      request->lib =
+        lilv_lib_open(world, lib_uri, bundle_path, request->features);
+
+      serd_free(bundle_path);
+    }
+  }
+
+  for (size_t j = 0; j < n_jobs; ++j) {
+    if (jobs[j].handle) {
+      dlclose(jobs[j].handle); // Drop the worker's reference to the library
     }
 
-    lilv_node_free(lib->uri);
-    free(lib->bundle_path);
-    free(lib);
+    serd_free(jobs[j].lib_path);
   }
+
+  free(jobs);
+}
+
+static bool
+lilv_lib_is_preloaded(const LilvWorld* world, const LilvLib* lib)
+{
+  for (size_t l = 0; l < world->n_preload_libs; ++l) {
+    if (world->preload_libs[l] == lib) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+unsigned
+lilv_world_preload_libraries(LilvWorld*                world,
+                             const LilvPlugin* const*  plugins,
+                             size_t                    n_plugins,
+                             const LV2_Feature* const* features,
+                             unsigned                  n_threads)
+{
+  LilvLibRequest* const requests =
+    (LilvLibRequest*)calloc(n_plugins ? n_plugins : 1U, sizeof(LilvLibRequest));
+
+  for (size_t p = 0; p < n_plugins; ++p) {
+    requests[p].plugin   = plugins[p];
+    requests[p].features = features;
+  }
+
+  lilv_lib_open_all(world, requests, n_plugins, n_threads);
+
+  // Keep one reference to each library, until trimmed
+  unsigned n_preloaded = 0U;
+  for (size_t p = 0; p < n_plugins; ++p) {
+    LilvLib* const lib = requests[p].lib;
+
+    if (lib && lilv_lib_is_preloaded(world, lib)) {
+      lilv_lib_close(lib); // Already held by this or an earlier call
+    } else if (lib) {
+      world->preload_libs = (LilvLib**)realloc(
+        world->preload_libs, ++world->n_preload_libs * sizeof(LilvLib*));
+
+      world->preload_libs[world->n_preload_libs - 1] = lib;
+      ++n_preloaded;
+    }
+  }
+
+  free(requests);
+  return n_preloaded;
+}
+
+unsigned
+lilv_lib_release_preloaded(LilvWorld* world)
+{
+  unsigned n_closed = 0U;
+
+  zix_sem_wait(&world->libs_lock);
+  for (size_t l = 0; l < world->n_preload_libs; ++l) {
+    n_closed += lilv_lib_close_locked(world->preload_libs[l]);
+  }
+  zix_sem_post(&world->libs_lock);
+
+  free(world->preload_libs);
+  world->preload_libs   = NULL;
+  world->n_preload_libs = 0U;
+  return n_closed;
 }
@@ -44,6 +44,13 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: clock_gettime()
+#  ifndef HAVE_CLOCK_GETTIME
+#    if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+#      define HAVE_CLOCK_GETTIME
+#    endif
+#  endif
+
 // POSIX.1-2001: fileno()
 #  ifndef HAVE_FILENO
 #    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
@@ -65,6 +72,27 @@
 #    endif
 #  endif
 
+// POSIX.1-2008: struct stat st_mtim
+#  ifndef HAVE_STAT_ST_MTIM
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+#      define HAVE_STAT_ST_MTIM
+#    endif
+#  endif
+
+// MacOS: struct stat st_mtimespec
+#  ifndef HAVE_STAT_ST_MTIMESPEC
+#    if defined(__APPLE__)
+#      define HAVE_STAT_ST_MTIMESPEC
+#    endif
+#  endif
+
+// Linux: inotify_init1()
+#  ifndef HAVE_INOTIFY
+#    if defined(__linux__)
+#      define HAVE_INOTIFY
+#    endif
+#  endif
+
 #endif // !defined(LILV_NO_DEFAULT_CONFIG)
 
 /*
@@ -75,6 +103,12 @@
   if the build system defines them all.
 */
 
+#ifdef HAVE_CLOCK_GETTIME
+#  define USE_CLOCK_GETTIME 1
+#else
+#  define USE_CLOCK_GETTIME 0
+#endif
+
 #ifdef HAVE_FILENO
 #  define USE_FILENO 1
 #else
@@ -87,12 +121,30 @@
 #  define USE_FLOCK 0
 #endif
 
+#ifdef HAVE_INOTIFY
+#  define USE_INOTIFY 1
+#else
+#  define USE_INOTIFY 0
+#endif
+
 #ifdef HAVE_LSTAT
 #  define USE_LSTAT 1
 #else
 #  define USE_LSTAT 0
 #endif
 
+#ifdef HAVE_STAT_ST_MTIM
+#  define USE_STAT_ST_MTIM 1
+#else
+#  define USE_STAT_ST_MTIM 0
+#endif
+
+#ifdef HAVE_STAT_ST_MTIMESPEC
+#  define USE_STAT_ST_MTIMESPEC 1
+#else
+#  define USE_STAT_ST_MTIMESPEC 0
+#endif
+
 /*
   Define required values.  These are always used as a fallback, even with
   LILV_NO_DEFAULT_CONFIG, since they must be defined for the build to work.
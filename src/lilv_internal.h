@@ -27,6 +27,8 @@ extern "C" {
 #include "lv2/core/lv2.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
+#include "zix/hash.h"
+#include "zix/sem.h"
 #include "zix/tree.h"
 
 #include <stdbool.h>
@@ -70,7 +72,35 @@ dlerror(void)
  *
  */
 
-typedef void LilvCollection;
+typedef struct LilvCollectionImpl LilvCollection;
+
+/** Number of standard port classes (see LilvPortClassFlag). */
+#define LILV_N_PORT_CLASSES 7U
+
+/** Number of standard port properties (see LilvPortPropertyFlag). */
+#define LILV_N_PORT_PROPERTIES 14U
+
+typedef struct LilvWatcherImpl LilvWatcher;
+
+typedef struct LilvTraceImpl LilvTrace;
+
+/** A set of small integers, like feature IDs. */
+typedef struct {
+  uint64_t* words;   ///< Bits, least significant bit first
+  uint32_t  n_words; ///< Number of words
+} LilvBitset;
+
+typedef struct LilvArenaBlockImpl LilvArenaBlock;
+
+/**
+   A region allocator for objects that live as long as the world.
+
+   Allocation is a pointer bump in the current block, and everything is freed
+   at once by lilv_arena_clear().  A zero-initialized arena is empty.
+*/
+typedef struct {
+  LilvArenaBlock* blocks;
+} LilvArena;
 
 struct LilvPortImpl {
   LilvNode*  node;    ///< RDF node
@@ -96,6 +126,24 @@ struct LilvHeader {
   LilvNode*  uri;
 };
 
+/**
+   A bundle that has been loaded into the world.
+
+   The stamp summarizes the modification times and sizes of the bundle
+   directory and the files in it, so lilv_world_rescan() can detect changes
+   without parsing anything.  The files and plugins loaded from the bundle are
+   recorded so that it can be unloaded without searching the whole world.
+*/
+typedef struct {
+  LilvWorld*   world;
+  LilvNode*    uri;
+  LilvNodes*   files;     ///< Files loaded from the bundle
+  LilvPlugin** plugins;   ///< Plugins described in the bundle
+  size_t       n_plugins; ///< Number of elements in plugins
+  uint64_t     stamp;     ///< Hash of bundle directory and file metadata
+  bool         seen;      ///< Found in LV2_PATH during the current rescan
+} LilvBundle;
+
 #ifdef LILV_DYN_MANIFEST
 typedef struct {
   LilvNode*               bundle;
@@ -112,9 +160,15 @@ typedef struct {
   void*                     lib;
   LV2_Descriptor_Function   lv2_descriptor;
   const LV2_Lib_Descriptor* desc;
+  ZixHash*                  descriptors; ///< Plugin descriptors by URI
   uint32_t                  refs;
 } LilvLib;
 
+typedef struct LilvVersion {
+  int minor;
+  int micro;
+} LilvVersion;
+
 struct LilvPluginImpl {
   LilvWorld* world;
   LilvNode*  plugin_uri;
@@ -127,16 +181,27 @@ struct LilvPluginImpl {
   LilvNodes*             data_uris; ///< rdfs::seeAlso
   LilvPort**             ports;
   uint32_t               num_ports;
+  LilvPort**             spare_ports;       ///< Unused ports, by index
+  uint32_t               n_spare_ports;     ///< Size of spare_ports
+  LilvPortTable*         port_table;        ///< Built on demand
+  bool                   has_latency;       ///< Valid if port_table
+  LilvBitset             required_features; ///< lv2:requiredFeature IDs
+  LilvBitset             optional_features; ///< lv2:optionalFeature IDs
+  LilvBitset             extension_data;    ///< lv2:extensionData IDs
+  LilvVersion            version;           ///< Valid if has_version
+  bool                   has_version;
   bool                   loaded;
   bool                   parse_errors;
   bool                   replaced;
 };
 
 struct LilvPluginClassImpl {
-  LilvWorld* world;
-  LilvNode*  uri;
-  LilvNode*  parent_uri;
-  LilvNode*  label;
+  LilvWorld*             world;
+  LilvNode*              uri;
+  LilvNode*              parent_uri;
+  LilvNode*              label;
+  const LilvPluginClass* parent;   ///< Parent class, if it is loaded
+  LilvPluginClasses*     children; ///< Direct subclasses (not owned)
 };
 
 struct LilvInstancePimpl {
@@ -145,9 +210,13 @@ struct LilvInstancePimpl {
 };
 
 typedef struct {
-  bool  dyn_manifest;
-  bool  filter_language;
-  char* lv2_path;
+  bool     dyn_manifest;
+  bool     filter_language;
+  char*    lv2_path;
+  char*    cache_dir;
+  unsigned discovery_threads;
+  unsigned keep_libraries;
+  bool     stats;
 } LilvOptions;
 
 struct LilvWorldImpl {
@@ -160,12 +229,35 @@ struct LilvWorldImpl {
   LilvSpec*          specs;
   LilvPlugins*       plugins;
   LilvPlugins*       zombies;
-  LilvNodes*         loaded_files;
+  ZixHash*           plugin_index; ///< Index of plugins by URI node
+  ZixHash*           zombie_index; ///< Index of zombies by URI node
+  ZixHash*           class_index;  ///< Index of plugin_classes by URI node
+  ZixHash*           replacements; ///< Replacement plugins by replaced URI
+  ZixTree*           loaded_files;
+  ZixHash*           nodes; ///< Interned resource nodes by SordNode
+  ZixHash*           feature_ids;  ///< Feature registry, URI => ID
+  SordNode**         feature_uris; ///< Feature registry, ID => URI
+  uint32_t           n_features;   ///< Number of registered features
+  ZixTree*           bundles;
+  LilvWatcher*       watcher;
   ZixTree*           libs;
+  ZixSem             libs_lock;       ///< Lock for opening and closing libs
+  LilvLib**          idle_libs;       ///< Unused open libs, oldest first
+  size_t             n_idle_libs;     ///< Number of unused open libs
+  LilvLib**          preload_libs;    ///< Libs held open by preloading
+  size_t             n_preload_libs;  ///< Number of preloaded libs
+  bool               specs_pending;   ///< Specifications must be loaded
+  bool               classes_pending; ///< Plugin classes must be loaded
   struct {
+    SordNode* atom_supports;
     SordNode* dc_replaces;
     SordNode* dman_DynManifest;
+    SordNode* doap_maintainer;
     SordNode* doap_name;
+    SordNode* ev_supportsEvent;
+    SordNode* foaf_homepage;
+    SordNode* foaf_mbox;
+    SordNode* foaf_name;
     SordNode* lv2_Plugin;
     SordNode* lv2_Specification;
     SordNode* lv2_appliesTo;
@@ -183,8 +275,10 @@ struct LilvWorldImpl {
     SordNode* lv2_optionalFeature;
     SordNode* lv2_port;
     SordNode* lv2_portProperty;
+    SordNode* lv2_project;
     SordNode* lv2_reportsLatency;
     SordNode* lv2_requiredFeature;
+    SordNode* lv2_scalePoint;
     SordNode* lv2_symbol;
     SordNode* lv2_prototype;
     SordNode* owl_Ontology;
@@ -195,6 +289,8 @@ struct LilvWorldImpl {
     SordNode* rdfs_label;
     SordNode* rdfs_seeAlso;
     SordNode* rdfs_subClassOf;
+    SordNode* ui_binary;
+    SordNode* ui_ui;
     SordNode* xsd_base64Binary;
     SordNode* xsd_boolean;
     SordNode* xsd_decimal;
@@ -202,7 +298,16 @@ struct LilvWorldImpl {
     SordNode* xsd_integer;
     SordNode* null_uri;
   } uris;
-  LilvOptions opt;
+  SordNode*      port_classes[LILV_N_PORT_CLASSES];       ///< By flag bit
+  SordNode*      port_properties[LILV_N_PORT_PROPERTIES]; ///< By flag bit
+  LilvOptions    opt;
+  LilvWorldStats stats;     ///< Counts of work done, if enabled
+  LilvArena      arena;     ///< Storage for plugins, ports, and classes
+  ZixSem         node_lock; ///< Lock for nodes while frozen
+  bool           frozen;    ///< True after lilv_world_freeze()
+#ifdef LILV_TRACE
+  LilvTrace* trace; ///< Trace event output, or NULL
+#endif
 };
 
 typedef enum {
@@ -215,10 +320,18 @@ typedef enum {
   LILV_VALUE_BLOB
 } LilvNodeType;
 
+/**
+   A node.
+
+   Resource nodes (URIs and blank nodes) are interned, so there is only one
+   shared and reference counted instance for each SordNode in a world.  Other
+   nodes are allocated for every use and have no reference count.
+*/
 struct LilvNodeImpl {
   LilvWorld*   world;
   SordNode*    node;
   LilvNodeType type;
+  uint32_t     refs; ///< Reference count if interned, otherwise zero
   union {
     int   int_val;
     float float_val;
@@ -239,10 +352,32 @@ struct LilvUIImpl {
   LilvNodes* classes;
 };
 
-typedef struct LilvVersion {
-  int minor;
-  int micro;
-} LilvVersion;
+/**
+   A data file to be parsed into a private model, possibly in another thread.
+
+   Jobs are parsed with lilv_world_parse_files(), then merged into the world
+   model one at a time, in order, with lilv_world_merge_file().
+*/
+typedef struct {
+  LilvNode*  uri;              ///< URI of file to parse
+  SordNode*  graph;            ///< Graph in world model to merge into
+  SordModel* model;            ///< Parsed statements, in a worker world
+  SerdStatus status;           ///< Parse status
+  uint8_t    blank_prefix[16]; ///< Blank node prefix
+  uint64_t   n_bytes;          ///< Size of file, if stats are enabled
+  uint64_t   read_us;          ///< Time spent loading, if stats are enabled
+  bool       cached;           ///< True if loaded from an up to date cache
+} LilvParseJob;
+
+/** A set of parse jobs, and the worker worlds that own the parsed data. */
+typedef struct {
+  LilvParseJob* jobs;
+  size_t        n_jobs;
+  const char*   cache_dir;
+  SordWorld**   worlds;
+  unsigned      n_worlds;
+  bool          stats;
+} LilvParseBatch;
 
 /*
  *
@@ -256,6 +391,11 @@ lilv_port_new(LilvWorld*      world,
               uint32_t        index,
               const char*     symbol);
 void
+lilv_port_reset(LilvWorld*      world,
+                LilvPort*       port,
+                const SordNode* node,
+                const char*     symbol);
+void
 lilv_port_free(const LilvPlugin* plugin, LilvPort* port);
 
 LilvPlugin*
@@ -270,11 +410,22 @@ lilv_plugin_load_if_necessary(const LilvPlugin* plugin);
 void
 lilv_plugin_free(LilvPlugin* plugin);
 
+/** Return the LilvPortClassFlag for a class URI, or zero. */
+uint32_t
+lilv_world_port_class_flag(const LilvWorld* world, const SordNode* uri);
+
+/** Return the LilvPortPropertyFlag for a property URI, or zero. */
+uint32_t
+lilv_world_port_property_flag(const LilvWorld* world, const SordNode* uri);
+
 LilvNode*
 lilv_plugin_get_unique(const LilvPlugin* plugin,
                        const SordNode*   subject,
                        const SordNode*   predicate);
 
+LilvCollection*
+lilv_collection_new(ZixComparator cmp, ZixDestroyFunc destructor);
+
 void
 lilv_collection_free(LilvCollection* collection);
 
@@ -287,6 +438,20 @@ lilv_collection_begin(const LilvCollection* collection);
 void*
 lilv_collection_get(const LilvCollection* collection, const LilvIter* i);
 
+/**
+   Insert an element into a collection, taking ownership of it.
+
+   Collections may only be modified while they are being built, since this
+   invalidates iterators.  If an equal element is already in the collection,
+   `elem` is destroyed and ZIX_STATUS_EXISTS is returned.
+*/
+ZixStatus
+lilv_collection_insert(LilvCollection* collection, void* elem);
+
+/** Return the element equal to `key`, or NULL. */
+void*
+lilv_collection_find(const LilvCollection* collection, const void* key);
+
 LilvPluginClass*
 lilv_plugin_class_new(LilvWorld*      world,
                       const SordNode* parent_node,
@@ -305,9 +470,41 @@ lilv_lib_open(LilvWorld*                world,
 const LV2_Descriptor*
 lilv_lib_get_plugin(LilvLib* lib, uint32_t index);
 
+/** Return the descriptor for the plugin with the given URI, or NULL. */
+const LV2_Descriptor*
+lilv_lib_get_plugin_by_uri(const LilvLib* lib, const char* uri);
+
 void
 lilv_lib_close(LilvLib* lib);
 
+/** A request to open the library of a plugin with lilv_lib_open_all(). */
+typedef struct {
+  const LilvPlugin*         plugin;   ///< Plugin whose library to open
+  const LV2_Feature* const* features; ///< Features for lv2_lib_descriptor
+  LilvLib*                  lib;      ///< Result, or NULL on failure
+} LilvLibRequest;
+
+/**
+   Open the library of every plugin in `requests`.
+
+   This loads plugin data, then loads the libraries with up to `n_threads`
+   threads and registers them from the calling thread.  Each successful
+   request holds a reference to its library that must be closed.
+*/
+void
+lilv_lib_open_all(LilvWorld*      world,
+                  LilvLibRequest* requests,
+                  size_t          n_requests,
+                  unsigned        n_threads);
+
+/** Close the least recently used idle libraries until at most `n` remain. */
+unsigned
+lilv_lib_trim(LilvWorld* world, size_t n);
+
+/** Drop the references held by preloading, and return the number closed. */
+unsigned
+lilv_lib_release_preloaded(LilvWorld* world);
+
 LilvNodes*
 lilv_nodes_new(void);
 
@@ -330,10 +527,86 @@ const uint8_t*
 lilv_world_blank_node_prefix(LilvWorld* world);
 
 SerdStatus
-lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri);
+lilv_world_load_graph(LilvWorld* world, SordNode* graph, const LilvNode* uri);
+
+void
+lilv_world_ensure_specifications(LilvWorld* world);
+
+void
+lilv_world_ensure_plugin_classes(LilvWorld* world);
+
+void
+lilv_plugin_class_index_children(LilvWorld* world);
+
+void
+lilv_world_add_loaded_file(LilvWorld*      world,
+                           const SordNode* graph,
+                           const LilvNode* uri);
+
+const char*
+lilv_world_lv2_path(const LilvWorld* world);
+
+void
+lilv_lv2_path_for_each(const char* lv2_path,
+                       void*       data,
+                       void (*func)(const char* dir, void* data));
+
+void
+lilv_watcher_free(LilvWatcher* watcher);
+
+/**
+   Load, reload, or unload bundles as necessary to bring them up to date.
+
+   Bundles that no longer exist are unloaded, new ones are loaded, and changed
+   ones (or all existing ones, if `force` is true) are reloaded.
+
+   @return The number of bundles that were loaded, reloaded, or unloaded.
+*/
+int
+lilv_world_refresh_bundles(LilvWorld*       world,
+                           LilvNode* const* uris,
+                           size_t           n_uris,
+                           bool             force);
+
+void
+lilv_world_parse_files(LilvWorld*      world,
+                       LilvParseBatch* batch,
+                       unsigned        n_threads);
 
 SerdStatus
-lilv_world_load_graph(LilvWorld* world, SordNode* graph, const LilvNode* uri);
+lilv_world_merge_file(LilvWorld* world, LilvParseJob* job);
+
+/**
+   Add the plugins replaced by `subject` to the index of replacements.
+
+   If `subject` is NULL, then the replacements of every plugin are added.
+*/
+void
+lilv_world_index_replacements(LilvWorld* world, const SordNode* subject);
+
+/** Count a loaded data file in the statistics, if they are enabled. */
+void
+lilv_world_count_file(LilvWorld* world,
+                      bool       cached,
+                      uint64_t   n_bytes,
+                      uint64_t   read_us);
+
+void
+lilv_parse_batch_clear(LilvParseBatch* batch);
+
+/**
+   Load a data file into `model`, via a cache file in `cache_dir`.
+
+   On return, `cached` is true if the data was read from an up to date cache
+   file, and false if the file was parsed.
+*/
+SerdStatus
+lilv_cache_load_file(const char*    cache_dir,
+                     SordModel*     model,
+                     SordNode*      graph,
+                     const char*    uri,
+                     const uint8_t* blank_prefix,
+                     bool*          cached);
 
 LilvUI*
 lilv_ui_new(LilvWorld* world,
@@ -344,6 +617,9 @@ lilv_ui_new(LilvWorld* world,
 void
 lilv_ui_free(LilvUI* ui);
 
+ZixHash*
+lilv_node_pool_new(void);
+
 LilvNode*
 lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str);
 
@@ -362,6 +638,29 @@ lilv_ptr_cmp(const void* a, const void* b, const void* user_data);
 int
 lilv_resource_node_cmp(const void* a, const void* b, const void* user_data);
 
+/**
+   Lock shared node state, if the world is frozen.
+
+   Creating or freeing nodes modifies reference counts and the intern table,
+   and creating or freeing iterators modifies the model, so this is done under
+   a lock when a frozen world may be used by several threads.
+*/
+static inline void
+lilv_world_lock_nodes(LilvWorld* world)
+{
+  if (world->frozen) {
+    zix_sem_wait(&world->node_lock);
+  }
+}
+
+static inline void
+lilv_world_unlock_nodes(LilvWorld* world)
+{
+  if (world->frozen) {
+    zix_sem_post(&world->node_lock);
+  }
+}
+
 static inline int
 lilv_version_cmp(const LilvVersion* a, const LilvVersion* b)
 {
@@ -377,7 +676,11 @@ lilv_version_cmp(const LilvVersion* a, const LilvVersion* b)
 }
 
 struct LilvHeader*
-lilv_collection_get_by_uri(const ZixTree* seq, const LilvNode* uri);
+lilv_collection_get_by_uri(const LilvCollection* collection,
+                           const LilvNode*       uri);
+
+struct LilvHeader*
+lilv_tree_get_by_uri(const ZixTree* tree, const LilvNode* uri);
 
 LilvScalePoint*
 lilv_scale_point_new(LilvNode* value, LilvNode* label);
@@ -391,6 +694,10 @@ lilv_world_query_internal(LilvWorld*      world,
                           const SordNode* predicate,
                           const SordNode* object);
 
+/** Free an iterator returned by lilv_world_query_internal(). */
+void
+lilv_world_iter_free(LilvWorld* world, SordIter* iter);
+
 bool
 lilv_world_ask_internal(LilvWorld*      world,
                         const SordNode* subject,
@@ -424,6 +731,53 @@ lilv_strjoin(const char* first, ...);
 char*
 lilv_strdup(const char* str);
 
+uint64_t
+lilv_hash_bytes(const void* buf, size_t len);
+
+/** Return the time of a monotonic clock in microseconds. */
+uint64_t
+lilv_time_us(void);
+
+/** Return the size of the local file at `uri`, or zero. */
+uint64_t
+lilv_file_uri_size(const char* uri);
+
+/** Allocate `size` zero-initialized bytes from `arena`. */
+void*
+lilv_arena_alloc(LilvArena* arena, size_t size);
+
+/** Free everything allocated from `arena`. */
+void
+lilv_arena_clear(LilvArena* arena);
+
+void
+lilv_bitset_set(LilvBitset* bits, uint32_t index);
+
+bool
+lilv_bitset_has(const LilvBitset* bits, uint32_t index);
+
+/** Return true iff every element of `a` is also in `b`. */
+bool
+lilv_bitset_is_subset(const LilvBitset* a, const LilvBitset* b);
+
+void
+lilv_bitset_clear(LilvBitset* bits);
+
+ZixHash*
+lilv_feature_registry_new(void);
+
+/** Set `id` to the ID of the feature `uri` and return true if it exists. */
+bool
+lilv_world_find_feature(LilvWorld* world, const SordNode* uri, uint32_t* id);
+
+/** Return the ID of the feature `uri`, registering it if necessary. */
+uint32_t
+lilv_world_intern_feature(LilvWorld* world, const SordNode* uri);
+
+/** Return a new collection of the features in `bits`. */
+LilvNodes*
+lilv_world_feature_nodes(LilvWorld* world, const LilvBitset* bits);
+
 char*
 lilv_get_lang(void);
 
@@ -460,6 +814,45 @@ void
 lilv_dynmanifest_free(LilvDynManifest* dynmanifest);
 #endif
 
+#ifdef LILV_TRACE
+
+/** A timed event that is written to the trace when it ends. */
+typedef struct {
+  LilvTrace*  trace; ///< Trace to write to, or NULL if tracing is disabled
+  const char* name;  ///< Event name, usually the function name
+  const char* arg;   ///< Argument string, which must live until the end
+  uint64_t    start; ///< Start time in microseconds
+} LilvTraceScope;
+
+/** Open a new trace file at `path` in the Chrome trace event format. */
+LilvTrace*
+lilv_trace_new(const char* path);
+
+/** Finish and close a trace file. */
+void
+lilv_trace_free(LilvTrace* trace);
+
+LilvTraceScope
+lilv_trace_begin(LilvTrace* trace, const char* name, const char* arg);
+
+void
+lilv_trace_end(const LilvTraceScope* scope);
+
+/** Begin tracing the rest of the calling function. */
+#  define LILV_TRACE_BEGIN(world, arg) \
+    const LilvTraceScope lilv_trace_scope = \
+      lilv_trace_begin((world)->trace, __func__, (arg))
+
+/** End the event started by LILV_TRACE_BEGIN(), before every return. */
+#  define LILV_TRACE_END() lilv_trace_end(&lilv_trace_scope)
+
+#else
+
+#  define LILV_TRACE_BEGIN(world, arg)
+#  define LILV_TRACE_END()
+
+#endif
+
 #define LILV_ERROR(str) fprintf(stderr, "%s(): error: " str, __func__)
 #define LILV_ERRORF(fmt, ...) \
   fprintf(stderr, "%s(): error: " fmt, __func__, __VA_ARGS__)
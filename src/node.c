@@ -20,6 +20,8 @@
 #include "lilv/lilv.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
+#include "zix/common.h"
+#include "zix/hash.h"
 
 #include <math.h>
 #include <stdbool.h>
@@ -28,6 +30,69 @@
 #include <stdlib.h>
 #include <string.h>
 
+static uint32_t
+lilv_node_pool_hash(const void* value)
+{
+  const SordNode* const node = (*(const LilvNode* const*)value)->node;
+
+  return (uint32_t)lilv_hash_bytes(&node, sizeof(node));
+}
+
+static bool
+lilv_node_pool_equals(const void* a, const void* b)
+{
+  return (*(const LilvNode* const*)a)->node ==
+         (*(const LilvNode* const*)b)->node;
+}
+
+ZixHash*
+lilv_node_pool_new(void)
+{
+  return zix_hash_new(
+    lilv_node_pool_hash, lilv_node_pool_equals, sizeof(LilvNode*));
+}
+
+static inline bool
+lilv_node_is_interned(const LilvNode* val)
+{
+  return val->type == LILV_VALUE_URI || val->type == LILV_VALUE_BLANK;
+}
+
+/**
+   Return a new reference to the interned resource node for `node`.
+
+   This takes ownership of a reference to `node`, and must be called with the
+   node lock held.
+*/
+static LilvNode*
+lilv_node_intern(LilvWorld* world, LilvNodeType type, SordNode* node)
+{
+  if (!node) {
+    return NULL;
+  }
+
+  const LilvNode        key     = {world, node, type, 0U, {0}};
+  const LilvNode* const key_ptr = &key;
+  LilvNode* const* const found =
+    (LilvNode* const*)zix_hash_find(world->nodes, &key_ptr);
+
+  if (found) {
+    sord_node_free(world->world, node);
+    ++(*found)->refs;
+    return *found;
+  }
+
+  LilvNode* const val = (LilvNode*)malloc(sizeof(LilvNode));
+  val->world          = world;
+  val->node           = node;
+  val->type           = type;
+  val->refs           = 1U;
+  val->val.int_val    = 0;
+
+  zix_hash_insert(world->nodes, &val, NULL);
+  return val;
+}
+
 static void
 lilv_node_set_numerics_from_string(LilvNode* val)
 {
@@ -51,25 +116,28 @@ lilv_node_set_numerics_from_string(LilvNode* val)
   }
 }
 
-/** Note that if `type` is numeric or boolean, the returned value is corrupt
- * until lilv_node_set_numerics_from_string is called.  It is not
- * automatically called from here to avoid overhead and imprecision when the
- * exact string value is known.
- */
-LilvNode*
-lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
+/** Create a new node, which must be called with the node lock held. */
+static LilvNode*
+lilv_node_new_locked(LilvWorld* world, LilvNodeType type, const char* str)
 {
+  const uint8_t* ustr = (const uint8_t*)str;
+  if (type == LILV_VALUE_URI) {
+    return lilv_node_intern(world, type, sord_new_uri(world->world, ustr));
+  }
+
+  if (type == LILV_VALUE_BLANK) {
+    return lilv_node_intern(world, type, sord_new_blank(world->world, ustr));
+  }
+
   LilvNode* val = (LilvNode*)malloc(sizeof(LilvNode));
   val->world    = world;
   val->type     = type;
+  val->refs     = 0U;
+  val->node     = NULL;
 
-  const uint8_t* ustr = (const uint8_t*)str;
   switch (type) {
   case LILV_VALUE_URI:
-    val->node = sord_new_uri(world->world, ustr);
-    break;
   case LILV_VALUE_BLANK:
-    val->node = sord_new_blank(world->world, ustr);
     break;
   case LILV_VALUE_STRING:
     val->node = sord_new_literal(world->world, NULL, ustr, NULL);
@@ -100,6 +168,20 @@ lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
   return val;
 }
 
+/** Note that if `type` is numeric or boolean, the returned value is corrupt
+ * until lilv_node_set_numerics_from_string is called.  It is not
+ * automatically called from here to avoid overhead and imprecision when the
+ * exact string value is known.
+ */
+LilvNode*
+lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
+{
+  lilv_world_lock_nodes(world);
+  LilvNode* const val = lilv_node_new_locked(world, type, str);
+  lilv_world_unlock_nodes(world);
+  return val;
+}
+
 /** Create a new LilvNode from `node`, or return NULL if impossible */
 LilvNode*
 lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
@@ -112,18 +194,13 @@ lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
   SordNode*    datatype_uri = NULL;
   LilvNodeType type         = LILV_VALUE_STRING;
 
+  lilv_world_lock_nodes(world);
   switch (sord_node_get_type(node)) {
   case SORD_URI:
-    result        = (LilvNode*)malloc(sizeof(LilvNode));
-    result->world = world;
-    result->type  = LILV_VALUE_URI;
-    result->node  = sord_node_copy(node);
+    result = lilv_node_intern(world, LILV_VALUE_URI, sord_node_copy(node));
     break;
   case SORD_BLANK:
-    result        = (LilvNode*)malloc(sizeof(LilvNode));
-    result->world = world;
-    result->type  = LILV_VALUE_BLANK;
-    result->node  = sord_node_copy(node);
+    result = lilv_node_intern(world, LILV_VALUE_BLANK, sord_node_copy(node));
     break;
   case SORD_LITERAL:
     datatype_uri = sord_node_get_datatype(node);
@@ -142,11 +219,12 @@ lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
                     sord_node_get_string(datatype_uri));
       }
     }
-    result =
-      lilv_node_new(world, type, (const char*)sord_node_get_string(node));
+    result = lilv_node_new_locked(
+      world, type, (const char*)sord_node_get_string(node));
     lilv_node_set_numerics_from_string(result);
     break;
   }
+  lilv_world_unlock_nodes(world);
 
   return result;
 }
@@ -217,21 +295,48 @@ lilv_node_duplicate(const LilvNode* val)
     return NULL;
   }
 
+  if (lilv_node_is_interned(val)) {
+    LilvNode* const shared = (LilvNode*)val;
+    lilv_world_lock_nodes(val->world);
+    ++shared->refs;
+    lilv_world_unlock_nodes(val->world);
+    return shared;
+  }
+
   LilvNode* result = (LilvNode*)malloc(sizeof(LilvNode));
   result->world    = val->world;
-  result->node     = sord_node_copy(val->node);
   result->val      = val->val;
   result->type     = val->type;
+  result->refs     = 0U;
+
+  lilv_world_lock_nodes(val->world);
+  result->node = sord_node_copy(val->node);
+  lilv_world_unlock_nodes(val->world);
   return result;
 }
 
 void
 lilv_node_free(LilvNode* val)
 {
-  if (val) {
-    sord_node_free(val->world->world, val->node);
-    free(val);
+  if (!val) {
+    return;
   }
+
+  LilvWorld* const world = val->world;
+
+  lilv_world_lock_nodes(world);
+  if (lilv_node_is_interned(val)) {
+    if (--val->refs) {
+      lilv_world_unlock_nodes(world);
+      return; // Still referenced elsewhere
+    }
+
+    zix_hash_remove(world->nodes, &val);
+  }
+
+  sord_node_free(world->world, val->node);
+  lilv_world_unlock_nodes(world);
+  free(val);
 }
 
 bool
@@ -241,6 +346,10 @@ lilv_node_equals(const LilvNode* value, const LilvNode* other)
     return true;
   }
 
+  if (value == other) {
+    return true; // Common case for interned resource nodes
+  }
+
   if (value == NULL || other == NULL || value->type != other->type) {
     return false;
   }
@@ -0,0 +1,229 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "serd/serd.h"
+#include "sord/sord.h"
+#include "zix/common.h"
+#include "zix/thread.h"
+#include "zix/tree.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  LilvParseBatch* batch;
+  unsigned        index;
+} LilvParseWorker;
+
+/** Parse a single job into a new model in `world`. */
+static void
+parse_job(const LilvParseBatch* batch, SordWorld* world, LilvParseJob* job)
+{
+  size_t               uri_len = 0;
+  const uint8_t* const uri_str =
+    sord_node_get_string_counted(job->uri->node, &uri_len);
+
+  if (strncmp((const char*)uri_str, "file:", 5) ||
+      uri_len < 4 || strcmp((const char*)uri_str + uri_len - 4, ".ttl")) {
+    job->status = SERD_FAILURE; // Not a local Turtle file
+    return;
+  }
+
+  const uint64_t start = batch->stats ? lilv_time_us() : 0U;
+
+  job->model  = sord_new(world, SORD_SPO, false);
+  job->cached = false;
+  if (batch->cache_dir) {
+    job->status = lilv_cache_load_file(batch->cache_dir,
+                                       job->model,
+                                       NULL,
+                                       (const char*)uri_str,
+                                       job->blank_prefix,
+                                       &job->cached);
+  } else {
+    const SerdNode base = serd_node_from_string(SERD_URI, uri_str);
+    SerdEnv*       env  = serd_env_new(&base);
+    SerdReader*    reader =
+      sord_new_reader(job->model, env, SERD_TURTLE, NULL);
+
+    serd_reader_add_blank_prefix(reader, job->blank_prefix);
+    job->status = serd_reader_read_file(reader, uri_str);
+
+    serd_reader_free(reader);
+    serd_env_free(env);
+  }
+
+  if (batch->stats) {
+    job->n_bytes = lilv_file_uri_size((const char*)uri_str);
+    job->read_us = lilv_time_us() - start;
+  }
+}
+
+/** Parse every job assigned to a worker (every n_worlds'th job). */
+static void*
+parse_worker(void* data)
+{
+  LilvParseWorker* const worker = (LilvParseWorker*)data;
+  LilvParseBatch* const  batch  = worker->batch;
+  SordWorld* const       world  = batch->worlds[worker->index];
+
+  for (size_t i = worker->index; i < batch->n_jobs; i += batch->n_worlds) {
+    parse_job(batch, world, &batch->jobs[i]);
+  }
+
+  return NULL;
+}
+
+void
+lilv_world_parse_files(LilvWorld*      world,
+                       LilvParseBatch* batch,
+                       unsigned        n_threads)
+{
+  LILV_TRACE_BEGIN(world, NULL);
+
+  if (n_threads < 1) {
+    n_threads = 1;
+  } else if (n_threads > batch->n_jobs) {
+    n_threads = batch->n_jobs ? (unsigned)batch->n_jobs : 1u;
+  }
+
+  // Assign blank node prefixes up front so they do not depend on timing
+  for (size_t i = 0; i < batch->n_jobs; ++i) {
+    snprintf((char*)batch->jobs[i].blank_prefix,
+             sizeof(batch->jobs[i].blank_prefix),
+             "%s",
+             (const char*)lilv_world_blank_node_prefix(world));
+  }
+
+  batch->n_worlds = n_threads;
+  batch->worlds   = (SordWorld**)calloc(n_threads, sizeof(SordWorld*));
+
+  LilvParseWorker* workers =
+    (LilvParseWorker*)calloc(n_threads, sizeof(LilvParseWorker));
+  ZixThread* threads = (ZixThread*)calloc(n_threads, sizeof(ZixThread));
+  bool*      started = (bool*)calloc(n_threads, sizeof(bool));
+
+  for (unsigned t = 0; t < n_threads; ++t) {
+    batch->worlds[t] = sord_world_new();
+    workers[t].batch = batch;
+    workers[t].index = t;
+  }
+
+  // Launch workers, using this thread for the first one
+  for (unsigned t = 1; t < n_threads; ++t) {
+    started[t] = !zix_thread_create(&threads[t], 0, parse_worker, &workers[t]);
+  }
+
+  parse_worker(&workers[0]);
+
+  for (unsigned t = 1; t < n_threads; ++t) {
+    if (started[t]) {
+      zix_thread_join(threads[t], NULL);
+    } else {
+      parse_worker(&workers[t]); // Failed to launch thread, run here
+    }
+  }
+
+  free(started);
+  free(threads);
+  free(workers);
+  LILV_TRACE_END();
+}
+
+/** Copy `node` from a worker world into `world`. */
+static SordNode*
+import_node(SordWorld* world, const SordNode* node)
+{
+  if (!node) {
+    return NULL;
+  }
+
+  const uint8_t* const str = sord_node_get_string(node);
+  switch (sord_node_get_type(node)) {
+  case SORD_URI:
+    return sord_new_uri(world, str);
+  case SORD_BLANK:
+    return sord_new_blank(world, str);
+  case SORD_LITERAL:
+    break;
+  }
+
+  SordNode* datatype = import_node(world, sord_node_get_datatype(node));
+  SordNode* literal =
+    sord_new_literal(world, datatype, str, sord_node_get_language(node));
+
+  sord_node_free(world, datatype);
+  return literal;
+}
+
+SerdStatus
+lilv_world_merge_file(LilvWorld* world, LilvParseJob* job)
+{
+  ZixTreeIter* iter = NULL;
+  if (!zix_tree_find(world->loaded_files, job->uri, &iter)) {
+    return SERD_FAILURE; // File has already been loaded
+  }
+
+  if (job->status) {
+    return job->status; // Reported by the caller
+  }
+
+  SordIter* i = sord_begin(job->model);
+  for (; !sord_iter_end(i); sord_iter_next(i)) {
+    SordQuad quad;
+    sord_iter_get(i, quad);
+
+    SordQuad copy = {import_node(world->world, quad[SORD_SUBJECT]),
+                     import_node(world->world, quad[SORD_PREDICATE]),
+                     import_node(world->world, quad[SORD_OBJECT]),
+                     job->graph};
+
+    sord_add(world->model, copy);
+
+    sord_node_free(world->world, (SordNode*)copy[SORD_OBJECT]);
+    sord_node_free(world->world, (SordNode*)copy[SORD_PREDICATE]);
+    sord_node_free(world->world, (SordNode*)copy[SORD_SUBJECT]);
+  }
+  sord_iter_free(i);
+
+  lilv_world_count_file(world, job->cached, job->n_bytes, job->read_us);
+  lilv_world_add_loaded_file(world, job->graph, job->uri);
+  return SERD_SUCCESS;
+}
+
+void
+lilv_parse_batch_clear(LilvParseBatch* batch)
+{
+  for (size_t i = 0; i < batch->n_jobs; ++i) {
+    sord_free(batch->jobs[i].model);
+    batch->jobs[i].model = NULL;
+  }
+
+  for (unsigned t = 0; t < batch->n_worlds; ++t) {
+    sord_world_free(batch->worlds[t]);
+  }
+
+  free(batch->worlds);
+  batch->worlds   = NULL;
+  batch->n_worlds = 0;
+}
@@ -19,10 +19,8 @@
 #include "lilv/lilv.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include "lv2/core/lv2.h"
-#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #  include "lv2/dynmanifest/dynmanifest.h"
@@ -36,9 +34,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define NS_DOAP (const uint8_t*)"http://usefulinc.com/ns/doap#"
-#define NS_FOAF (const uint8_t*)"http://xmlns.com/foaf/0.1/"
-
 static void
 lilv_plugin_init(LilvPlugin* plugin, LilvNode* bundle_uri)
 {
@@ -51,46 +46,115 @@ lilv_plugin_init(LilvPlugin* plugin, LilvNode* bundle_uri)
   plugin->data_uris    = lilv_nodes_new();
   plugin->ports        = NULL;
   plugin->num_ports    = 0;
+  plugin->port_table   = NULL;
+  plugin->has_latency  = false;
   plugin->loaded       = false;
   plugin->parse_errors = false;
   plugin->replaced     = false;
+  plugin->has_version  = false;
 }
 
 /** Ownership of `uri` and `bundle` is taken */
 LilvPlugin*
 lilv_plugin_new(LilvWorld* world, LilvNode* uri, LilvNode* bundle_uri)
 {
-  LilvPlugin* plugin = (LilvPlugin*)malloc(sizeof(LilvPlugin));
+  LilvPlugin* plugin =
+    (LilvPlugin*)lilv_arena_alloc(&world->arena, sizeof(LilvPlugin));
 
-  plugin->world      = world;
-  plugin->plugin_uri = uri;
+  plugin->world         = world;
+  plugin->plugin_uri    = uri;
+  plugin->spare_ports   = NULL;
+  plugin->n_spare_ports = 0;
 
   lilv_plugin_init(plugin, bundle_uri);
   return plugin;
 }
 
-void
-lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri)
+static void
+lilv_port_table_free(LilvPortTable* table)
 {
-  lilv_node_free(plugin->bundle_uri);
-  lilv_node_free(plugin->binary_uri);
-  lilv_nodes_free(plugin->data_uris);
-  lilv_plugin_init(plugin, bundle_uri);
+  if (table) {
+    for (uint32_t i = 0; i < table->n_ports; ++i) {
+      lilv_node_free((LilvNode*)table->designations[i]);
+    }
+
+    free(table);
+  }
+}
+
+static void
+lilv_plugin_free_features(LilvPlugin* plugin)
+{
+  lilv_bitset_clear(&plugin->required_features);
+  lilv_bitset_clear(&plugin->optional_features);
+  lilv_bitset_clear(&plugin->extension_data);
 }
 
+/**
+   Unload the ports of a plugin.
+
+   Ports are in the world arena and may still be referenced by the user, so
+   they are kept intact as spares, and reused by index when ports are loaded
+   again.
+*/
 static void
 lilv_plugin_free_ports(LilvPlugin* plugin)
 {
+  lilv_port_table_free(plugin->port_table);
+  plugin->port_table  = NULL;
+  plugin->has_latency = false;
+
   if (plugin->ports) {
+    if (plugin->num_ports > plugin->n_spare_ports) {
+      plugin->spare_ports = (LilvPort**)realloc(
+        plugin->spare_ports, plugin->num_ports * sizeof(LilvPort*));
+      memset(plugin->spare_ports + plugin->n_spare_ports,
+             '\0',
+             (plugin->num_ports - plugin->n_spare_ports) * sizeof(LilvPort*));
+      plugin->n_spare_ports = plugin->num_ports;
+    }
+
     for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-      lilv_port_free(plugin, plugin->ports[i]);
+      if (plugin->ports[i]) {
+        plugin->spare_ports[i] = plugin->ports[i];
+      }
     }
+
     free(plugin->ports);
     plugin->num_ports = 0;
     plugin->ports     = NULL;
   }
 }
 
+/** Return a port to use for `index`, reusing a spare one if possible. */
+static LilvPort*
+lilv_plugin_new_port(LilvPlugin*     plugin,
+                     const SordNode* node,
+                     uint32_t        index,
+                     const char*     symbol)
+{
+  if (index < plugin->n_spare_ports && plugin->spare_ports[index]) {
+    LilvPort* const port = plugin->spare_ports[index];
+
+    plugin->spare_ports[index] = NULL;
+    lilv_port_reset(plugin->world, port, node, symbol);
+    return port;
+  }
+
+  return lilv_port_new(plugin->world, node, index, symbol);
+}
+
+void
+lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri)
+{
+  lilv_node_free(plugin->bundle_uri);
+  lilv_node_free(plugin->binary_uri);
+  lilv_nodes_free(plugin->data_uris);
+  lilv_plugin_free_ports(plugin);
+  lilv_plugin_free_features(plugin);
+  lilv_plugin_init(plugin, bundle_uri);
+}
+
 void
 lilv_plugin_free(LilvPlugin* plugin)
 {
@@ -110,11 +174,19 @@ lilv_plugin_free(LilvPlugin* plugin)
   plugin->binary_uri = NULL;
 
   lilv_plugin_free_ports(plugin);
+  lilv_plugin_free_features(plugin);
+
+  for (uint32_t i = 0; i < plugin->n_spare_ports; ++i) {
+    lilv_port_free(plugin, plugin->spare_ports[i]);
+  }
+  free(plugin->spare_ports);
+  plugin->spare_ports   = NULL;
+  plugin->n_spare_ports = 0;
 
   lilv_nodes_free(plugin->data_uris);
   plugin->data_uris = NULL;
 
-  free(plugin);
+  // The plugin itself is in the world arena and freed along with it
 }
 
 static LilvNode*
@@ -154,15 +226,50 @@ lilv_plugin_get_unique(const LilvPlugin* plugin,
   return ret;
 }
 
+/** Record the IDs of all objects of `predicate` for `plugin` in `bits`. */
+static void
+lilv_plugin_load_feature_ids(LilvPlugin*     plugin,
+                             const SordNode* predicate,
+                             LilvBitset*     bits)
+{
+  LilvWorld* const world = plugin->world;
+  SordIter* const  i =
+    lilv_world_query_internal(world, plugin->plugin_uri->node, predicate, NULL);
+
+  FOREACH_MATCH (i) {
+    const SordNode* const uri = sord_iter_get_node(i, SORD_OBJECT);
+
+    lilv_bitset_set(bits, lilv_world_intern_feature(world, uri));
+  }
+
+  lilv_world_iter_free(world, i);
+}
+
+/** Record the features and extension data of a plugin as bit sets. */
+static void
+lilv_plugin_load_features(LilvPlugin* plugin)
+{
+  const LilvWorld* const world = plugin->world;
+
+  lilv_plugin_free_features(plugin);
+  lilv_plugin_load_feature_ids(
+    plugin, world->uris.lv2_requiredFeature, &plugin->required_features);
+  lilv_plugin_load_feature_ids(
+    plugin, world->uris.lv2_optionalFeature, &plugin->optional_features);
+  lilv_plugin_load_feature_ids(
+    plugin, world->uris.lv2_extensionData, &plugin->extension_data);
+}
+
 static void
 lilv_plugin_load(LilvPlugin* plugin)
 {
-  SordNode*       bundle_uri_node  = plugin->bundle_uri->node;
-  const SerdNode* bundle_uri_snode = sord_node_to_serd_node(bundle_uri_node);
+  SordNode* bundle_uri_node = plugin->bundle_uri->node;
 
-  SerdEnv*    env = serd_env_new(bundle_uri_snode);
-  SerdReader* reader =
-    sord_new_reader(plugin->world->model, env, SERD_TURTLE, bundle_uri_node);
+  LILV_TRACE_BEGIN(plugin->world, lilv_node_as_string(plugin->plugin_uri));
+
+  if (plugin->world->opt.stats) {
+    ++plugin->world->stats.n_plugin_loads;
+  }
 
   SordModel* prots = lilv_world_filter_model(plugin->world,
                                              plugin->world->model,
@@ -178,8 +285,8 @@ lilv_plugin_load(LilvPlugin* plugin)
 
     lilv_world_load_resource(plugin->world, prototype);
 
-    SordIter* statements =
-      sord_search(plugin->world->model, prototype->node, NULL, NULL, NULL);
+    SordIter* statements = lilv_world_query_internal(
+      plugin->world, prototype->node, NULL, NULL);
     FOREACH_MATCH (statements) {
       SordQuad quad;
       sord_iter_get(statements, quad);
@@ -187,7 +294,7 @@ lilv_plugin_load(LilvPlugin* plugin)
       sord_add(skel, quad);
     }
 
-    sord_iter_free(statements);
+    lilv_world_iter_free(plugin->world, statements);
     lilv_node_free(prototype);
   }
   sord_iter_free(iter);
@@ -206,18 +313,20 @@ lilv_plugin_load(LilvPlugin* plugin)
   LILV_FOREACH (nodes, i, plugin->data_uris) {
     const LilvNode* data_uri = lilv_nodes_get(plugin->data_uris, i);
 
-    serd_env_set_base_uri(env, sord_node_to_serd_node(data_uri->node));
-    st = lilv_world_load_file(plugin->world, reader, data_uri);
+    st = lilv_world_load_graph(plugin->world, bundle_uri_node, data_uri);
     if (st > SERD_FAILURE) {
       break;
     }
   }
 
+  // Data files often describe what the plugin replaces
+  lilv_world_index_replacements(plugin->world, plugin->plugin_uri->node);
+
   if (st > SERD_FAILURE) {
+    lilv_plugin_load_features(plugin);
     plugin->loaded       = true;
     plugin->parse_errors = true;
-    serd_reader_free(reader);
-    serd_env_free(env);
+    LILV_TRACE_END();
     return;
   }
 
@@ -230,7 +339,10 @@ lilv_plugin_load(LilvPlugin* plugin)
       plugin->dynmanifest->lib, "lv2_dyn_manifest_get_data");
     if (get_data_func) {
       const SordNode* bundle = plugin->dynmanifest->bundle->node;
-      serd_env_set_base_uri(env, sord_node_to_serd_node(bundle));
+      SerdEnv*        env    = serd_env_new(sord_node_to_serd_node(bundle));
+      SerdReader*     reader = sord_new_reader(
+        plugin->world->model, env, SERD_TURTLE, bundle_uri_node);
+
       FILE* fd = tmpfile();
       get_data_func(plugin->dynmanifest->handle,
                     fd,
@@ -241,13 +353,15 @@ lilv_plugin_load(LilvPlugin* plugin)
       serd_reader_read_file_handle(
         reader, fd, (const uint8_t*)"(dyn-manifest)");
       fclose(fd);
+      serd_reader_free(reader);
+      serd_env_free(env);
     }
   }
 #endif
-  serd_reader_free(reader);
-  serd_env_free(env);
 
+  lilv_plugin_load_features(plugin);
   plugin->loaded = true;
+  LILV_TRACE_END();
 }
 
 static bool
@@ -322,8 +436,8 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 
       // Havn't seen this port yet, add it to array
       if (!this_port) {
-        this_port = lilv_port_new(
-          plugin->world, port, this_index, lilv_node_as_string(symbol));
+        this_port = lilv_plugin_new_port(
+          plugin, port, this_index, lilv_node_as_string(symbol));
         plugin->ports[this_index] = this_port;
       }
 
@@ -332,20 +446,19 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
       FOREACH_MATCH (types) {
         const SordNode* type = sord_iter_get_node(types, SORD_OBJECT);
         if (sord_node_get_type(type) == SORD_URI) {
-          zix_tree_insert((ZixTree*)this_port->classes,
-                          lilv_node_new_from_node(plugin->world, type),
-                          NULL);
+          lilv_collection_insert(this_port->classes,
+                                 lilv_node_new_from_node(plugin->world, type));
         } else {
           LILV_WARNF("Plugin <%s> port type is not a URI\n",
                      lilv_node_as_uri(plugin->plugin_uri));
         }
       }
-      sord_iter_free(types);
+      lilv_world_iter_free(plugin->world, types);
 
       lilv_node_free(symbol);
       lilv_node_free(index);
     }
-    sord_iter_free(ports);
+    lilv_world_iter_free(plugin->world, ports);
 
     // Check sanity
     for (uint32_t i = 0; i < plugin->num_ports; ++i) {
@@ -399,7 +512,7 @@ lilv_plugin_get_library_uri(const LilvPlugin* plugin)
         break;
       }
     }
-    sord_iter_free(i);
+    lilv_world_iter_free(plugin->world, i);
   }
   if (!plugin->binary_uri) {
     LILV_WARNF("Plugin <%s> has no lv2:binary\n",
@@ -419,6 +532,8 @@ lilv_plugin_get_class(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
   if (!plugin->plugin_class) {
+    lilv_world_ensure_plugin_classes(plugin->world);
+
     // <plugin> a ?class
     SordIter* c = lilv_world_query_internal(
       plugin->world, plugin->plugin_uri->node, plugin->world->uris.rdf_a, NULL);
@@ -442,7 +557,7 @@ lilv_plugin_get_class(const LilvPlugin* plugin)
 
       lilv_node_free(klass);
     }
-    sord_iter_free(c);
+    lilv_world_iter_free(plugin->world, c);
 
     if (plugin->plugin_class == NULL) {
       ((LilvPlugin*)plugin)->plugin_class = plugin->world->lv2_plugin_class;
@@ -532,50 +647,138 @@ lilv_plugin_get_num_ports(const LilvPlugin* plugin)
   return plugin->num_ports;
 }
 
+/** Return the numeric value of `node`, or NAN if it is not a number. */
+static float
+lilv_node_as_float_or_nan(const LilvNode* node)
+{
+  return (lilv_node_is_float(node) || lilv_node_is_int(node))
+           ? lilv_node_as_float(node)
+           : NAN;
+}
+
+/** Return the numeric value of a port property, or NAN. */
+static float
+lilv_port_get_float(const LilvPlugin* plugin,
+                    const LilvPort*   port,
+                    const SordNode*   predicate)
+{
+  LilvNode* const value =
+    lilv_plugin_get_one(plugin, port->node->node, predicate);
+
+  const float f = lilv_node_as_float_or_nan(value);
+
+  lilv_node_free(value);
+  return f;
+}
+
+static LilvPortTable*
+lilv_port_table_new(LilvPlugin* plugin)
+{
+  LilvWorld* const world = plugin->world;
+  const uint32_t   n     = plugin->num_ports;
+
+  // Allocate the table and all its arrays in a single block
+  const size_t row_size = (2 * sizeof(LilvNode*)) + (2 * sizeof(uint32_t)) +
+                          (3 * sizeof(float));
+
+  LilvPortTable* const table =
+    (LilvPortTable*)calloc(1, sizeof(LilvPortTable) + (n * row_size));
+
+  const LilvNode** const symbols      = (const LilvNode**)(table + 1);
+  const LilvNode** const designations = symbols + n;
+  uint32_t* const        classes      = (uint32_t*)(designations + n);
+  uint32_t* const        properties   = classes + n;
+  float* const           defaults     = (float*)(properties + n);
+  float* const           minimums     = defaults + n;
+  float* const           maximums     = minimums + n;
+
+  for (uint32_t i = 0; i < n; ++i) {
+    const LilvPort* const port = plugin->ports[i];
+
+    symbols[i] = port->symbol;
+
+    LILV_FOREACH (nodes, c, port->classes) {
+      const LilvNode* const port_class = lilv_nodes_get(port->classes, c);
+
+      classes[i] |= lilv_world_port_class_flag(world, port_class->node);
+    }
+
+    SordIter* props = lilv_world_query_internal(
+      world, port->node->node, world->uris.lv2_portProperty, NULL);
+    FOREACH_MATCH (props) {
+      const SordNode* const prop = sord_iter_get_node(props, SORD_OBJECT);
+
+      properties[i] |= lilv_world_port_property_flag(world, prop);
+    }
+    lilv_world_iter_free(world, props);
+
+    defaults[i] = lilv_port_get_float(plugin, port, world->uris.lv2_default);
+    minimums[i] = lilv_port_get_float(plugin, port, world->uris.lv2_minimum);
+    maximums[i] = lilv_port_get_float(plugin, port, world->uris.lv2_maximum);
+
+    designations[i] = lilv_plugin_get_one(
+      plugin, port->node->node, world->uris.lv2_designation);
+
+    // A port may have several designations, so this is checked separately
+    if ((properties[i] & LILV_PORT_PROP_REPORTS_LATENCY) ||
+        lilv_world_ask_internal(world,
+                                port->node->node,
+                                world->uris.lv2_designation,
+                                world->uris.lv2_latency)) {
+      plugin->has_latency = true;
+    }
+  }
+
+  table->n_ports      = n;
+  table->symbols      = symbols;
+  table->classes      = classes;
+  table->properties   = properties;
+  table->defaults     = defaults;
+  table->minimums     = minimums;
+  table->maximums     = maximums;
+  table->designations = designations;
+  return table;
+}
+
+const LilvPortTable*
+lilv_plugin_get_port_table(const LilvPlugin* plugin)
+{
+  lilv_plugin_load_ports_if_necessary(plugin);
+
+  if (!plugin->port_table && plugin->ports) {
+    ((LilvPlugin*)plugin)->port_table =
+      lilv_port_table_new((LilvPlugin*)plugin);
+    if (plugin->world->opt.stats) {
+      ++plugin->world->stats.n_port_tables;
+    }
+  }
+
+  return plugin->port_table;
+}
+
 void
 lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
                                   float*            min_values,
                                   float*            max_values,
                                   float*            def_values)
 {
-  lilv_plugin_load_ports_if_necessary(plugin);
-  LilvNode*  min    = NULL;
-  LilvNode*  max    = NULL;
-  LilvNode*  def    = NULL;
-  LilvNode** minptr = min_values ? &min : NULL;
-  LilvNode** maxptr = max_values ? &max : NULL;
-  LilvNode** defptr = def_values ? &def : NULL;
-
-  for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-    lilv_port_get_range(plugin, plugin->ports[i], defptr, minptr, maxptr);
+  const LilvPortTable* const table = lilv_plugin_get_port_table(plugin);
+  if (!table) {
+    return;
+  }
 
-    if (min_values) {
-      if (lilv_node_is_float(min) || lilv_node_is_int(min)) {
-        min_values[i] = lilv_node_as_float(min);
-      } else {
-        min_values[i] = NAN;
-      }
-    }
+  const size_t size = table->n_ports * sizeof(float);
 
-    if (max_values) {
-      if (lilv_node_is_float(max) || lilv_node_is_int(max)) {
-        max_values[i] = lilv_node_as_float(max);
-      } else {
-        max_values[i] = NAN;
-      }
-    }
+  if (min_values) {
+    memcpy(min_values, table->minimums, size);
+  }
 
-    if (def_values) {
-      if (lilv_node_is_float(def) || lilv_node_is_int(def)) {
-        def_values[i] = lilv_node_as_float(def);
-      } else {
-        def_values[i] = NAN;
-      }
-    }
+  if (max_values) {
+    memcpy(max_values, table->maximums, size);
+  }
 
-    lilv_node_free(def);
-    lilv_node_free(min);
-    lilv_node_free(max);
+  if (def_values) {
+    memcpy(def_values, table->defaults, size);
   }
 }
 
@@ -636,7 +839,11 @@ lilv_plugin_get_num_ports_of_class(const LilvPlugin* plugin,
 bool
 lilv_plugin_has_latency(const LilvPlugin* plugin)
 {
-  lilv_plugin_load_if_necessary(plugin);
+  const LilvPortTable* const table = lilv_plugin_get_port_table(plugin);
+  if (table) {
+    return plugin->has_latency;
+  }
+
   SordIter* ports = lilv_world_query_internal(plugin->world,
                                               plugin->plugin_uri->node,
                                               plugin->world->uris.lv2_port,
@@ -659,14 +866,14 @@ lilv_plugin_has_latency(const LilvPlugin* plugin)
                                 plugin->world->uris.lv2_latency);
 
     const bool latent = !sord_iter_end(prop) || !sord_iter_end(des);
-    sord_iter_free(prop);
-    sord_iter_free(des);
+    lilv_world_iter_free(plugin->world, prop);
+    lilv_world_iter_free(plugin->world, des);
     if (latent) {
       ret = true;
       break;
     }
   }
-  sord_iter_free(ports);
+  lilv_world_iter_free(plugin->world, ports);
 
   return ret;
 }
@@ -675,6 +882,22 @@ static const LilvPort*
 lilv_plugin_get_port_by_property(const LilvPlugin* plugin,
                                  const SordNode*   port_property)
 {
+  const uint32_t flag =
+    lilv_world_port_property_flag(plugin->world, port_property);
+
+  const LilvPortTable* const table =
+    flag ? lilv_plugin_get_port_table(plugin) : NULL;
+
+  if (table) {
+    for (uint32_t i = 0; i < table->n_ports; ++i) {
+      if (table->properties[i] & flag) {
+        return plugin->ports[i];
+      }
+    }
+
+    return NULL;
+  }
+
   lilv_plugin_load_ports_if_necessary(plugin);
   for (uint32_t i = 0; i < plugin->num_ports; ++i) {
     LilvPort* port = plugin->ports[i];
@@ -685,7 +908,7 @@ lilv_plugin_get_port_by_property(const LilvPlugin* plugin,
                                 port_property);
 
     const bool found = !sord_iter_end(iter);
-    sord_iter_free(iter);
+    lilv_world_iter_free(plugin->world, iter);
 
     if (found) {
       return port;
@@ -710,7 +933,7 @@ lilv_plugin_get_port_by_designation(const LilvPlugin* plugin,
     const bool found =
       !sord_iter_end(iter) &&
       (!port_class || lilv_port_is_a(plugin, port, port_class));
-    sord_iter_free(iter);
+    lilv_world_iter_free(world, iter);
 
     if (found) {
       return port;
@@ -749,17 +972,11 @@ bool
 lilv_plugin_has_feature(const LilvPlugin* plugin, const LilvNode* feature)
 {
   lilv_plugin_load_if_necessary(plugin);
-  const SordNode* predicates[] = {plugin->world->uris.lv2_requiredFeature,
-                                  plugin->world->uris.lv2_optionalFeature,
-                                  NULL};
 
-  for (const SordNode** pred = predicates; *pred; ++pred) {
-    if (lilv_world_ask_internal(
-          plugin->world, plugin->plugin_uri->node, *pred, feature->node)) {
-      return true;
-    }
-  }
-  return false;
+  uint32_t id = 0U;
+  return lilv_world_find_feature(plugin->world, feature->node, &id) &&
+         (lilv_bitset_has(&plugin->required_features, id) ||
+          lilv_bitset_has(&plugin->optional_features, id));
 }
 
 LilvNodes*
@@ -777,20 +994,14 @@ LilvNodes*
 lilv_plugin_get_optional_features(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary(plugin);
-  return lilv_world_find_nodes_internal(plugin->world,
-                                        plugin->plugin_uri->node,
-                                        plugin->world->uris.lv2_optionalFeature,
-                                        NULL);
+  return lilv_world_feature_nodes(plugin->world, &plugin->optional_features);
 }
 
 LilvNodes*
 lilv_plugin_get_required_features(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary(plugin);
-  return lilv_world_find_nodes_internal(plugin->world,
-                                        plugin->plugin_uri->node,
-                                        plugin->world->uris.lv2_requiredFeature,
-                                        NULL);
+  return lilv_world_feature_nodes(plugin->world, &plugin->required_features);
 }
 
 bool
@@ -803,17 +1014,17 @@ lilv_plugin_has_extension_data(const LilvPlugin* plugin, const LilvNode* uri)
   }
 
   lilv_plugin_load_if_necessary(plugin);
-  return lilv_world_ask_internal(plugin->world,
-                                 plugin->plugin_uri->node,
-                                 plugin->world->uris.lv2_extensionData,
-                                 uri->node);
+
+  uint32_t id = 0U;
+  return lilv_world_find_feature(plugin->world, uri->node, &id) &&
+         lilv_bitset_has(&plugin->extension_data, id);
 }
 
 LilvNodes*
 lilv_plugin_get_extension_data(const LilvPlugin* plugin)
 {
-  return lilv_plugin_get_value_internal(plugin,
-                                        plugin->world->uris.lv2_extensionData);
+  lilv_plugin_load_if_necessary(plugin);
+  return lilv_world_feature_nodes(plugin->world, &plugin->extension_data);
 }
 
 const LilvPort*
@@ -846,22 +1057,18 @@ lilv_plugin_get_project(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary(plugin);
 
-  SordNode* lv2_project =
-    sord_new_uri(plugin->world->world, (const uint8_t*)LV2_CORE__project);
-
-  SordIter* projects = lilv_world_query_internal(
-    plugin->world, plugin->plugin_uri->node, lv2_project, NULL);
-
-  sord_node_free(plugin->world->world, lv2_project);
+  LilvWorld* const world    = plugin->world;
+  SordIter*        projects = lilv_world_query_internal(
+    world, plugin->plugin_uri->node, world->uris.lv2_project, NULL);
 
   if (sord_iter_end(projects)) {
-    sord_iter_free(projects);
+    lilv_world_iter_free(world, projects);
     return NULL;
   }
 
   const SordNode* project = sord_iter_get_node(projects, SORD_OBJECT);
 
-  sord_iter_free(projects);
+  lilv_world_iter_free(world, projects);
   return lilv_node_new_from_node(plugin->world, project);
 }
 
@@ -870,18 +1077,16 @@ lilv_plugin_get_author(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary(plugin);
 
-  SordNode* doap_maintainer =
-    sord_new_uri(plugin->world->world, NS_DOAP "maintainer");
+  const SordNode* const doap_maintainer = plugin->world->uris.doap_maintainer;
 
   SordIter* maintainers = lilv_world_query_internal(
     plugin->world, plugin->plugin_uri->node, doap_maintainer, NULL);
 
   if (sord_iter_end(maintainers)) {
-    sord_iter_free(maintainers);
+    lilv_world_iter_free(plugin->world, maintainers);
 
     LilvNode* project = lilv_plugin_get_project(plugin);
     if (!project) {
-      sord_node_free(plugin->world->world, doap_maintainer);
       return NULL;
     }
 
@@ -891,29 +1096,24 @@ lilv_plugin_get_author(const LilvPlugin* plugin)
     lilv_node_free(project);
   }
 
-  sord_node_free(plugin->world->world, doap_maintainer);
-
   if (sord_iter_end(maintainers)) {
-    sord_iter_free(maintainers);
+    lilv_world_iter_free(plugin->world, maintainers);
     return NULL;
   }
 
   const SordNode* author = sord_iter_get_node(maintainers, SORD_OBJECT);
 
-  sord_iter_free(maintainers);
+  lilv_world_iter_free(plugin->world, maintainers);
   return author;
 }
 
 static LilvNode*
-lilv_plugin_get_author_property(const LilvPlugin* plugin, const uint8_t* uri)
+lilv_plugin_get_author_property(const LilvPlugin* plugin,
+                                const SordNode*   predicate)
 {
   const SordNode* author = lilv_plugin_get_author(plugin);
   if (author) {
-    SordWorld* sworld = plugin->world->world;
-    SordNode*  pred   = sord_new_uri(sworld, uri);
-    LilvNode*  ret    = lilv_plugin_get_one(plugin, author, pred);
-    sord_node_free(sworld, pred);
-    return ret;
+    return lilv_plugin_get_one(plugin, author, predicate);
   }
   return NULL;
 }
@@ -921,19 +1121,22 @@ lilv_plugin_get_author_property(const LilvPlugin* plugin, const uint8_t* uri)
 LilvNode*
 lilv_plugin_get_author_name(const LilvPlugin* plugin)
 {
-  return lilv_plugin_get_author_property(plugin, NS_FOAF "name");
+  return lilv_plugin_get_author_property(plugin,
+                                         plugin->world->uris.foaf_name);
 }
 
 LilvNode*
 lilv_plugin_get_author_email(const LilvPlugin* plugin)
 {
-  return lilv_plugin_get_author_property(plugin, NS_FOAF "mbox");
+  return lilv_plugin_get_author_property(plugin,
+                                         plugin->world->uris.foaf_mbox);
 }
 
 LilvNode*
 lilv_plugin_get_author_homepage(const LilvPlugin* plugin)
 {
-  return lilv_plugin_get_author_property(plugin, NS_FOAF "homepage");
+  return lilv_plugin_get_author_property(plugin,
+                                         plugin->world->uris.foaf_homepage);
 }
 
 bool
@@ -947,10 +1150,8 @@ lilv_plugin_get_uis(const LilvPlugin* plugin)
 {
   lilv_plugin_load_if_necessary(plugin);
 
-  SordNode* ui_ui_node =
-    sord_new_uri(plugin->world->world, (const uint8_t*)LV2_UI__ui);
-  SordNode* ui_binary_node =
-    sord_new_uri(plugin->world->world, (const uint8_t*)LV2_UI__binary);
+  const SordNode* const ui_ui_node     = plugin->world->uris.ui_ui;
+  const SordNode* const ui_binary_node = plugin->world->uris.ui_binary;
 
   LilvUIs*  result = lilv_uis_new();
   SordIter* uis    = lilv_world_query_internal(
@@ -978,12 +1179,9 @@ lilv_plugin_get_uis(const LilvPlugin* plugin)
     LilvUI* lilv_ui = lilv_ui_new(
       plugin->world, lilv_node_new_from_node(plugin->world, ui), type, binary);
 
-    zix_tree_insert((ZixTree*)result, lilv_ui, NULL);
+    lilv_collection_insert(result, lilv_ui);
   }
-  sord_iter_free(uis);
-
-  sord_node_free(plugin->world->world, ui_binary_node);
-  sord_node_free(plugin->world->world, ui_ui_node);
+  lilv_world_iter_free(plugin->world, uis);
 
   if (lilv_uis_size(result) > 0) {
     return result;
@@ -1008,11 +1206,10 @@ lilv_plugin_get_related(const LilvPlugin* plugin, const LilvNode* type)
 
   LilvNodes* matches = lilv_nodes_new();
   LILV_FOREACH (nodes, i, related) {
-    LilvNode* node = (LilvNode*)lilv_collection_get((ZixTree*)related, i);
+    LilvNode* node = (LilvNode*)lilv_collection_get(related, i);
     if (lilv_world_ask_internal(
           world, node->node, world->uris.rdf_a, type->node)) {
-      zix_tree_insert(
-        (ZixTree*)matches, lilv_node_new_from_node(world, node->node), NULL);
+      lilv_collection_insert(matches, lilv_node_duplicate(node));
     }
   }
 
@@ -29,12 +29,15 @@ lilv_plugin_class_new(LilvWorld*      world,
                       const SordNode* uri,
                       const char*     label)
 {
-  LilvPluginClass* pc = (LilvPluginClass*)malloc(sizeof(LilvPluginClass));
+  LilvPluginClass* pc =
+    (LilvPluginClass*)lilv_arena_alloc(&world->arena, sizeof(LilvPluginClass));
   pc->world           = world;
   pc->uri             = lilv_node_new_from_node(world, uri);
   pc->label           = lilv_node_new(world, LILV_VALUE_STRING, label);
   pc->parent_uri =
     (parent_node ? lilv_node_new_from_node(world, parent_node) : NULL);
+  pc->parent   = NULL;
+  pc->children = NULL;
   return pc;
 }
 
@@ -48,7 +51,9 @@ lilv_plugin_class_free(LilvPluginClass* plugin_class)
   lilv_node_free(plugin_class->uri);
   lilv_node_free(plugin_class->parent_uri);
   lilv_node_free(plugin_class->label);
-  free(plugin_class);
+  lilv_collection_free(plugin_class->children);
+
+  // The class itself is in the world arena and freed along with it
 }
 
 const LilvNode*
@@ -69,23 +74,155 @@ lilv_plugin_class_get_label(const LilvPluginClass* plugin_class)
   return plugin_class->label;
 }
 
+/** Return the indexed class with the same URI as `plugin_class`, or NULL. */
+static const LilvPluginClass*
+lilv_plugin_class_get_indexed(const LilvPluginClass* plugin_class)
+{
+  LilvWorld* const world = plugin_class->world;
+
+  lilv_world_ensure_plugin_classes(world);
+
+  return lilv_node_equals(plugin_class->uri, world->lv2_plugin_class->uri)
+           ? world->lv2_plugin_class
+           : lilv_plugin_classes_get_by_uri(world->plugin_classes,
+                                            plugin_class->uri);
+}
+
+void
+lilv_plugin_class_index_children(LilvWorld* world)
+{
+  LilvPluginClass* const   root = world->lv2_plugin_class;
+  LilvPluginClasses* const all  = world->plugin_classes;
+
+  lilv_collection_free(root->children);
+  root->children = NULL;
+  LILV_FOREACH (plugin_classes, i, all) {
+    LilvPluginClass* const c = (LilvPluginClass*)lilv_collection_get(all, i);
+
+    lilv_collection_free(c->children);
+    c->children = NULL;
+    c->parent   = NULL;
+  }
+
+  // Classes are visited in order, so children are appended in order
+  LILV_FOREACH (plugin_classes, i, all) {
+    LilvPluginClass* const c = (LilvPluginClass*)lilv_collection_get(all, i);
+    if (!c->parent_uri) {
+      continue;
+    }
+
+    LilvPluginClass* const parent =
+      lilv_node_equals(c->parent_uri, root->uri)
+        ? root
+        : (LilvPluginClass*)lilv_plugin_classes_get_by_uri(all, c->parent_uri);
+
+    if (parent) {
+      if (!parent->children) {
+        parent->children =
+          lilv_collection_new(lilv_header_compare_by_uri, NULL);
+      }
+
+      c->parent = parent;
+      lilv_collection_insert(parent->children, c);
+    }
+  }
+}
+
 LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class)
 {
+  const LilvPluginClass* const indexed =
+    lilv_plugin_class_get_indexed(plugin_class);
+
   // Returned list doesn't own categories
-  LilvPluginClasses* all    = plugin_class->world->plugin_classes;
-  LilvPluginClasses* result = zix_tree_new(false, lilv_ptr_cmp, NULL, NULL);
-
-  for (ZixTreeIter* i = zix_tree_begin((ZixTree*)all);
-       i != zix_tree_end((ZixTree*)all);
-       i = zix_tree_iter_next(i)) {
-    const LilvPluginClass* c      = (LilvPluginClass*)zix_tree_get(i);
-    const LilvNode*        parent = lilv_plugin_class_get_parent_uri(c);
-    if (parent &&
-        lilv_node_equals(lilv_plugin_class_get_uri(plugin_class), parent)) {
-      zix_tree_insert((ZixTree*)result, (LilvPluginClass*)c, NULL);
+  LilvPluginClasses* result =
+    lilv_collection_new(lilv_header_compare_by_uri, NULL);
+  if (!indexed) {
+    return result;
+  }
+
+  LILV_FOREACH (plugin_classes, i, indexed->children) {
+    lilv_collection_insert(result, lilv_collection_get(indexed->children, i));
+  }
+
+  return result;
+}
+
+/** Add every plugin that is an instance of `plugin_class` to `plugins`. */
+static void
+lilv_plugin_class_add_instances(const LilvPluginClass* plugin_class,
+                                LilvPlugins*           plugins)
+{
+  LilvWorld* const world = plugin_class->world;
+
+  // ?plugin a <plugin_class>
+  SordIter* const i = lilv_world_query_internal(
+    world, NULL, world->uris.rdf_a, plugin_class->uri->node);
+
+  FOREACH_MATCH (i) {
+    const SordNode* const node = sord_iter_get_node(i, SORD_SUBJECT);
+    if (sord_node_get_type(node) == SORD_URI) {
+      LilvNode* const         uri = lilv_node_new_from_node(world, node);
+      const LilvPlugin* const plugin =
+        lilv_plugins_get_by_uri(world->plugins, uri);
+
+      if (plugin) {
+        zix_tree_insert((ZixTree*)plugins, (LilvPlugin*)plugin, NULL);
+      }
+
+      lilv_node_free(uri);
     }
   }
 
+  lilv_world_iter_free(world, i);
+}
+
+/** Add instances of `plugin_class` and its descendants, up to `depth`. */
+static void
+lilv_plugin_class_add_subtree(const LilvPluginClass* plugin_class,
+                              LilvPlugins*           plugins,
+                              const unsigned         depth)
+{
+  lilv_plugin_class_add_instances(plugin_class, plugins);
+
+  if (depth && plugin_class->children) {
+    LILV_FOREACH (plugin_classes, i, plugin_class->children) {
+      const LilvPluginClass* const child =
+        lilv_plugin_classes_get(plugin_class->children, i);
+
+      lilv_plugin_class_add_subtree(child, plugins, depth - 1U);
+    }
+  }
+}
+
+LilvPlugins*
+lilv_plugin_class_get_plugins(const LilvPluginClass* plugin_class)
+{
+  const LilvPluginClass* const indexed =
+    lilv_plugin_class_get_indexed(plugin_class);
+
+  LilvWorld* const   world  = plugin_class->world;
+  LilvPlugins* const result = lilv_plugins_new();
+
+  if (indexed == world->lv2_plugin_class) {
+    // Every plugin is an lv2:Plugin
+    LILV_FOREACH (plugins, i, world->plugins) {
+      const LilvPlugin* const plugin = lilv_plugins_get(world->plugins, i);
+      zix_tree_insert((ZixTree*)result, (LilvPlugin*)plugin, NULL);
+    }
+  } else if (indexed) {
+    // Specific classes are usually only in data files, so load any missing
+    LILV_FOREACH (plugins, i, world->plugins) {
+      if (!lilv_plugins_get(world->plugins, i)->loaded) {
+        lilv_world_load_all_plugin_data(world);
+        break;
+      }
+    }
+
+    // Union of class instances in the subtree (with a limit for cycles)
+    lilv_plugin_class_add_subtree(
+      indexed, result, lilv_plugin_classes_size(world->plugin_classes));
+  }
+
   return result;
 }
@@ -16,13 +16,10 @@
 
 #include "lilv_internal.h"
 
-#include "lv2/atom/atom.h"
 #include "lv2/core/lv2.h"
-#include "lv2/event/event.h"
 
 #include "lilv/lilv.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include <assert.h>
 #include <stdbool.h>
@@ -36,7 +33,7 @@ lilv_port_new(LilvWorld*      world,
               uint32_t        index,
               const char*     symbol)
 {
-  LilvPort* port = (LilvPort*)malloc(sizeof(LilvPort));
+  LilvPort* port = (LilvPort*)lilv_arena_alloc(&world->arena, sizeof(LilvPort));
   port->node     = lilv_node_new_from_node(world, node);
   port->index    = index;
   port->symbol   = lilv_node_new(world, LILV_VALUE_STRING, symbol);
@@ -44,6 +41,21 @@ lilv_port_new(LilvWorld*      world,
   return port;
 }
 
+void
+lilv_port_reset(LilvWorld*      world,
+                LilvPort*       port,
+                const SordNode* node,
+                const char*     symbol)
+{
+  lilv_node_free(port->node);
+  lilv_nodes_free(port->classes);
+  lilv_node_free(port->symbol);
+
+  port->node    = lilv_node_new_from_node(world, node);
+  port->symbol  = lilv_node_new(world, LILV_VALUE_STRING, symbol);
+  port->classes = lilv_nodes_new();
+}
+
 void
 lilv_port_free(const LilvPlugin* plugin, LilvPort* port)
 {
@@ -53,7 +65,9 @@ lilv_port_free(const LilvPlugin* plugin, LilvPort* port)
     lilv_node_free(port->node);
     lilv_nodes_free(port->classes);
     lilv_node_free(port->symbol);
-    free(port);
+    port->node    = NULL;
+    port->classes = NULL;
+    port->symbol  = NULL;
   }
 }
 
@@ -64,13 +78,7 @@ lilv_port_is_a(const LilvPlugin* plugin,
 {
   (void)plugin;
 
-  LILV_FOREACH (nodes, i, port->classes) {
-    if (lilv_node_equals(lilv_nodes_get(port->classes, i), port_class)) {
-      return true;
-    }
-  }
-
-  return false;
+  return lilv_nodes_contains(port->classes, port_class);
 }
 
 bool
@@ -78,6 +86,16 @@ lilv_port_has_property(const LilvPlugin* plugin,
                        const LilvPort*   port,
                        const LilvNode*   property)
 {
+  const uint32_t flag =
+    lilv_world_port_property_flag(plugin->world, property->node);
+
+  const LilvPortTable* const table =
+    flag ? lilv_plugin_get_port_table(plugin) : NULL;
+
+  if (table) {
+    return table->properties[port->index] & flag;
+  }
+
   return lilv_world_ask_internal(plugin->world,
                                  port->node->node,
                                  plugin->world->uris.lv2_portProperty,
@@ -89,15 +107,13 @@ lilv_port_supports_event(const LilvPlugin* plugin,
                          const LilvPort*   port,
                          const LilvNode*   event_type)
 {
-  const uint8_t* predicates[] = {(const uint8_t*)LV2_EVENT__supportsEvent,
-                                 (const uint8_t*)LV2_ATOM__supports,
-                                 NULL};
-
-  for (const uint8_t** pred = predicates; *pred; ++pred) {
-    if (lilv_world_ask_internal(plugin->world,
-                                port->node->node,
-                                sord_new_uri(plugin->world->world, *pred),
-                                event_type->node)) {
+  const SordNode* predicates[] = {plugin->world->uris.ev_supportsEvent,
+                                  plugin->world->uris.atom_supports,
+                                  NULL};
+
+  for (const SordNode** pred = predicates; *pred; ++pred) {
+    if (lilv_world_ask_internal(
+          plugin->world, port->node->node, *pred, event_type->node)) {
       return true;
     }
   }
@@ -231,11 +247,9 @@ lilv_port_get_range(const LilvPlugin* plugin,
 LilvScalePoints*
 lilv_port_get_scale_points(const LilvPlugin* plugin, const LilvPort* port)
 {
-  SordIter* points = lilv_world_query_internal(
-    plugin->world,
-    port->node->node,
-    sord_new_uri(plugin->world->world, (const uint8_t*)LV2_CORE__scalePoint),
-    NULL);
+  LilvWorld* const world  = plugin->world;
+  SordIter*        points = lilv_world_query_internal(
+    world, port->node->node, world->uris.lv2_scalePoint, NULL);
 
   LilvScalePoints* ret = NULL;
   if (!sord_iter_end(points)) {
@@ -252,10 +266,10 @@ lilv_port_get_scale_points(const LilvPlugin* plugin, const LilvPort* port)
       lilv_plugin_get_unique(plugin, point, plugin->world->uris.rdfs_label);
 
     if (value && label) {
-      zix_tree_insert((ZixTree*)ret, lilv_scale_point_new(value, label), NULL);
+      lilv_collection_insert(ret, lilv_scale_point_new(value, label));
     }
   }
-  sord_iter_free(points);
+  lilv_world_iter_free(world, points);
 
   assert(!ret || lilv_nodes_size(ret) > 0);
   return ret;
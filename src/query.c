@@ -18,7 +18,6 @@
 
 #include "lilv/lilv.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -72,8 +71,7 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
         switch (lilv_lang_matches(lang, syslang)) {
         case LILV_LANG_MATCH_EXACT:
           // Exact language match, add to results
-          zix_tree_insert(
-            (ZixTree*)values, lilv_node_new_from_node(world, value), NULL);
+          lilv_collection_insert(values, lilv_node_new_from_node(world, value));
           break;
         case LILV_LANG_MATCH_PARTIAL:
           // Partial language match, save in case we find no exact
@@ -84,11 +82,10 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
         }
       }
     } else {
-      zix_tree_insert(
-        (ZixTree*)values, lilv_node_new_from_node(world, value), NULL);
+      lilv_collection_insert(values, lilv_node_new_from_node(world, value));
     }
   }
-  sord_iter_free(stream);
+  lilv_world_iter_free(world, stream);
   free(syslang);
 
   if (lilv_nodes_size(values) > 0) {
@@ -106,8 +103,7 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
   }
 
   if (best) {
-    zix_tree_insert(
-      (ZixTree*)values, lilv_node_new_from_node(world, best), NULL);
+    lilv_collection_insert(values, lilv_node_new_from_node(world, best));
   } else {
     // No matches whatsoever
     lilv_nodes_free(values);
@@ -123,7 +119,7 @@ lilv_nodes_from_stream_objects(LilvWorld*    world,
                                SordQuadIndex field)
 {
   if (sord_iter_end(stream)) {
-    sord_iter_free(stream);
+    lilv_world_iter_free(world, stream);
     return NULL;
   }
 
@@ -136,9 +132,9 @@ lilv_nodes_from_stream_objects(LilvWorld*    world,
     const SordNode* value = sord_iter_get_node(stream, field);
     LilvNode*       node  = lilv_node_new_from_node(world, value);
     if (node) {
-      zix_tree_insert((ZixTree*)values, node, NULL);
+      lilv_collection_insert(values, node);
     }
   }
-  sord_iter_free(stream);
+  lilv_world_iter_free(world, stream);
   return values;
 }
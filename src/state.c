@@ -742,6 +742,8 @@ lilv_state_new_from_file(LilvWorld*      world,
     return NULL;
   }
 
+  LILV_TRACE_BEGIN(world, path);
+
   uint8_t*    abs_path = (uint8_t*)lilv_path_absolute(path);
   SerdNode    node     = serd_node_new_file_uri(abs_path, NULL, NULL, true);
   SerdEnv*    env      = serd_env_new(&node);
@@ -768,6 +770,7 @@ lilv_state_new_from_file(LilvWorld*      world,
   serd_reader_free(reader);
   sord_free(model);
   serd_env_free(env);
+  LILV_TRACE_END();
   return state;
 }
 
@@ -1229,6 +1232,8 @@ lilv_state_save(LilvWorld*       world,
     return 1;
   }
 
+  LILV_TRACE_BEGIN(world, filename);
+
   char*       abs_dir = real_dir(dir);
   char* const path    = lilv_path_join(abs_dir, filename);
   FILE*       fd      = fopen(path, "w");
@@ -1236,6 +1241,7 @@ lilv_state_save(LilvWorld*       world,
     LILV_ERRORF("Failed to open %s (%s)\n", path, strerror(errno));
     free(abs_dir);
     free(path);
+    LILV_TRACE_END();
     return 4;
   }
 
@@ -1272,6 +1278,7 @@ lilv_state_save(LilvWorld*       world,
 
   free(abs_dir);
   free(path);
+  LILV_TRACE_END();
   return ret;
 }
 
@@ -0,0 +1,185 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#ifdef LILV_TRACE
+
+#  include "zix/sem.h"
+
+#  ifdef _WIN32
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#  endif
+
+#  include <inttypes.h>
+#  include <stdbool.h>
+#  include <stdint.h>
+#  include <stdio.h>
+#  include <stdlib.h>
+
+#  ifdef _WIN32
+
+typedef DWORD LilvThreadId;
+
+static LilvThreadId
+lilv_thread_self(void)
+{
+  return GetCurrentThreadId();
+}
+
+static bool
+lilv_thread_equals(LilvThreadId a, LilvThreadId b)
+{
+  return a == b;
+}
+
+#  else
+
+typedef pthread_t LilvThreadId;
+
+static LilvThreadId
+lilv_thread_self(void)
+{
+  return pthread_self();
+}
+
+static bool
+lilv_thread_equals(LilvThreadId a, LilvThreadId b)
+{
+  return pthread_equal(a, b);
+}
+
+#  endif
+
+struct LilvTraceImpl {
+  FILE*         stream;    ///< Output file
+  uint64_t      origin;    ///< Time the trace was opened
+  bool          empty;     ///< True if no events have been written
+  ZixSem        lock;      ///< Lock for writing events from several threads
+  LilvThreadId* threads;   ///< Threads that have written events, by tid
+  unsigned      n_threads; ///< Number of elements in threads
+};
+
+/** Return the trace ID of the calling thread, which must hold the lock. */
+static unsigned
+lilv_trace_thread_id(LilvTrace* trace)
+{
+  const LilvThreadId self = lilv_thread_self();
+
+  for (unsigned i = 0U; i < trace->n_threads; ++i) {
+    if (lilv_thread_equals(trace->threads[i], self)) {
+      return i + 1U;
+    }
+  }
+
+  trace->threads = (LilvThreadId*)realloc(
+    trace->threads, ++trace->n_threads * sizeof(LilvThreadId));
+
+  trace->threads[trace->n_threads - 1U] = self;
+  return trace->n_threads;
+}
+
+LilvTrace*
+lilv_trace_new(const char* path)
+{
+  FILE* const stream = fopen(path, "w");
+  if (!stream) {
+    LILV_ERRORF("Failed to open trace file %s\n", path);
+    return NULL;
+  }
+
+  LilvTrace* const trace = (LilvTrace*)calloc(1, sizeof(LilvTrace));
+  trace->stream          = stream;
+  trace->origin          = lilv_time_us();
+  trace->empty           = true;
+  zix_sem_init(&trace->lock, 1);
+
+  fprintf(stream, "[");
+  return trace;
+}
+
+void
+lilv_trace_free(LilvTrace* trace)
+{
+  if (trace) {
+    fprintf(trace->stream, "\n]\n");
+    fclose(trace->stream);
+    zix_sem_destroy(&trace->lock);
+    free(trace->threads);
+    free(trace);
+  }
+}
+
+LilvTraceScope
+lilv_trace_begin(LilvTrace* trace, const char* name, const char* arg)
+{
+  const LilvTraceScope scope = {
+    trace, name, arg, trace ? lilv_time_us() : 0U};
+
+  return scope;
+}
+
+/** Write `str` as the contents of a JSON string. */
+static void
+write_escaped(FILE* stream, const char* str)
+{
+  for (const char* s = str; *s; ++s) {
+    if (*s == '"' || *s == '\\') {
+      fprintf(stream, "\\%c", *s);
+    } else if ((unsigned char)*s < 0x20) {
+      fprintf(stream, "\\u%04X", (unsigned)*s);
+    } else {
+      fputc(*s, stream);
+    }
+  }
+}
+
+void
+lilv_trace_end(const LilvTraceScope* scope)
+{
+  LilvTrace* const trace = scope->trace;
+  if (!trace) {
+    return;
+  }
+
+  const uint64_t end = lilv_time_us();
+
+  zix_sem_wait(&trace->lock);
+
+  fprintf(trace->stream,
+          "%s\n{\"name\":\"%s\",\"cat\":\"lilv\",\"ph\":\"X\",\"pid\":1,"
+          "\"tid\":%u,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64,
+          trace->empty ? "" : ",",
+          scope->name,
+          lilv_trace_thread_id(trace),
+          scope->start - trace->origin,
+          end - scope->start);
+
+  if (scope->arg) {
+    fprintf(trace->stream, ",\"args\":{\"arg\":\"");
+    write_escaped(trace->stream, scope->arg);
+    fprintf(trace->stream, "\"}");
+  }
+
+  fprintf(trace->stream, "}");
+  trace->empty = false;
+
+  zix_sem_post(&trace->lock);
+}
+
+#endif // LILV_TRACE
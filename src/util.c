@@ -15,6 +15,7 @@
 */
 
 #include "filesystem.h"
+#include "lilv_config.h"
 #include "lilv_internal.h"
 
 #include "lilv/lilv.h"
@@ -32,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 void
 lilv_free(void* ptr)
@@ -87,6 +89,19 @@ lilv_strdup(const char* str)
   return copy;
 }
 
+uint64_t
+lilv_hash_bytes(const void* buf, const size_t len)
+{
+  // 64-bit FNV-1a
+  const uint8_t* const bytes = (const uint8_t*)buf;
+  uint64_t             hash  = 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+  }
+
+  return hash;
+}
+
 const char*
 lilv_uri_to_path(const char* uri)
 {
@@ -108,6 +123,33 @@ lilv_file_uri_parse(const char* uri, char** hostname)
   return (char*)serd_file_uri_parse((const uint8_t*)uri, (uint8_t**)hostname);
 }
 
+uint64_t
+lilv_time_us(void)
+{
+#if USE_CLOCK_GETTIME
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+#else
+  return (uint64_t)clock() * 1000000U / CLOCKS_PER_SEC;
+#endif
+}
+
+uint64_t
+lilv_file_uri_size(const char* uri)
+{
+  char* const path  = lilv_file_uri_parse(uri, NULL);
+  uint64_t    size  = 0U;
+  int64_t     mtime = 0;
+
+  if (!path || lilv_file_stamp(path, &size, &mtime)) {
+    size = 0U;
+  }
+
+  lilv_free(path);
+  return size;
+}
+
 /** Return the current LANG converted to Turtle (i.e. RFC3066) style.
  * For example, if LANG is set to "en_CA.utf-8", this returns "en-ca".
  */
@@ -0,0 +1,344 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_config.h"
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#if USE_INOTIFY
+#  include "filesystem.h"
+
+#  include "serd/serd.h"
+
+#  include <errno.h>
+#  include <sys/inotify.h>
+#  include <time.h>
+#  include <unistd.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if USE_INOTIFY
+
+/** Time a bundle must be quiet before changes to it are applied. */
+#  define LILV_WATCH_DELAY_MS 250U
+
+/** Events that indicate that the entries in a directory have changed. */
+#  define LILV_WATCH_ENTRY_EVENTS \
+    (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+/** Events that indicate that a bundle or a file in it has changed. */
+#  define LILV_WATCH_BUNDLE_EVENTS \
+    (LILV_WATCH_ENTRY_EVENTS | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | \
+     IN_MOVE_SELF)
+
+/** A watched directory, either in LV2_PATH or a bundle. */
+typedef struct {
+  int   wd;        ///< Inotify watch descriptor
+  char* path;      ///< Directory path (with trailing slash for bundles)
+  bool  is_bundle; ///< True if this is a bundle, not an LV2_PATH directory
+} LilvWatchDir;
+
+/** A bundle with pending changes. */
+typedef struct {
+  char*    path;    ///< Bundle path, with trailing slash
+  uint64_t time_ms; ///< Time of the last event for this bundle
+} LilvWatchChange;
+
+struct LilvWatcherImpl {
+  int              fd;
+  LilvWatchDir*    dirs;
+  size_t           n_dirs;
+  LilvWatchChange* changes;
+  size_t           n_changes;
+  uint64_t         overflow_ms; ///< Time of the last queue overflow
+  bool             overflowed;  ///< True if events were lost
+};
+
+static uint64_t
+lilv_watch_now_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+static void
+lilv_watcher_add_dir(LilvWatcher* watcher, const char* path, bool is_bundle)
+{
+  const uint32_t events =
+    is_bundle ? LILV_WATCH_BUNDLE_EVENTS : LILV_WATCH_ENTRY_EVENTS;
+
+  const int wd = inotify_add_watch(watcher->fd, path, IN_ONLYDIR | events);
+  if (wd < 0) {
+    if (!is_bundle) {
+      LILV_WARNF("Failed to watch %s (%s)\n", path, strerror(errno));
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < watcher->n_dirs; ++i) {
+    if (watcher->dirs[i].wd == wd) {
+      return; // Already watched (watch descriptors are unique per inode)
+    }
+  }
+
+  watcher->dirs = (LilvWatchDir*)realloc(
+    watcher->dirs, ++watcher->n_dirs * sizeof(LilvWatchDir));
+
+  LilvWatchDir* const dir = &watcher->dirs[watcher->n_dirs - 1];
+  dir->wd                 = wd;
+  dir->path               = lilv_strdup(path);
+  dir->is_bundle          = is_bundle;
+}
+
+static void
+lilv_watcher_remove_dir(LilvWatcher* watcher, const int wd)
+{
+  for (size_t i = 0; i < watcher->n_dirs; ++i) {
+    if (watcher->dirs[i].wd == wd) {
+      free(watcher->dirs[i].path);
+      watcher->dirs[i] = watcher->dirs[--watcher->n_dirs];
+      return;
+    }
+  }
+}
+
+static const LilvWatchDir*
+lilv_watcher_find_dir(const LilvWatcher* watcher, const int wd)
+{
+  for (size_t i = 0; i < watcher->n_dirs; ++i) {
+    if (watcher->dirs[i].wd == wd) {
+      return &watcher->dirs[i];
+    }
+  }
+
+  return NULL;
+}
+
+/** Note a change to the bundle at `path`, taking ownership of `path`. */
+static void
+lilv_watcher_note_change(LilvWatcher* watcher, char* path, uint64_t now)
+{
+  for (size_t i = 0; i < watcher->n_changes; ++i) {
+    if (!strcmp(watcher->changes[i].path, path)) {
+      watcher->changes[i].time_ms = now;
+      free(path);
+      return;
+    }
+  }
+
+  watcher->changes = (LilvWatchChange*)realloc(
+    watcher->changes, ++watcher->n_changes * sizeof(LilvWatchChange));
+
+  watcher->changes[watcher->n_changes - 1].path    = path;
+  watcher->changes[watcher->n_changes - 1].time_ms = now;
+}
+
+static void
+watch_bundle_entry(const char* dir, const char* name, void* data)
+{
+  char* const path = lilv_strjoin(dir, "/", name, "/", NULL);
+
+  if (lilv_is_directory(path)) {
+    lilv_watcher_add_dir((LilvWatcher*)data, path, true);
+  }
+
+  free(path);
+}
+
+static void
+watch_lv2_dir(const char* dir, void* data)
+{
+  if (lilv_is_directory(dir)) {
+    lilv_watcher_add_dir((LilvWatcher*)data, dir, false);
+    lilv_dir_for_each(dir, data, watch_bundle_entry);
+  }
+}
+
+/** Read all available events and record the bundles they affect. */
+static void
+lilv_watcher_read(LilvWatcher* watcher)
+{
+  union {
+    struct inotify_event event;
+    char                 buf[4096];
+  } u;
+
+  const uint64_t now = lilv_watch_now_ms();
+  ssize_t        len = 0;
+  while ((len = read(watcher->fd, u.buf, sizeof(u.buf))) > 0) {
+    for (const char* p = u.buf; p < u.buf + len;) {
+      const struct inotify_event* const event =
+        (const struct inotify_event*)p;
+
+      p += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were dropped, so anything may have changed
+        watcher->overflowed  = true;
+        watcher->overflow_ms = now;
+        continue;
+      }
+
+      const LilvWatchDir* const dir = lilv_watcher_find_dir(watcher, event->wd);
+      if (!dir) {
+        continue;
+      }
+
+      if (event->mask & IN_IGNORED) {
+        lilv_watcher_remove_dir(watcher, event->wd);
+      } else if (dir->is_bundle) {
+        lilv_watcher_note_change(watcher, lilv_strdup(dir->path), now);
+      } else if (event->len && (event->mask & IN_ISDIR)) {
+        char* const path = lilv_strjoin(dir->path, "/", event->name, "/", NULL);
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+          lilv_watcher_add_dir(watcher, path, true);
+        }
+
+        lilv_watcher_note_change(watcher, path, now);
+      }
+    }
+  }
+}
+
+void
+lilv_watcher_free(LilvWatcher* watcher)
+{
+  if (watcher) {
+    for (size_t i = 0; i < watcher->n_changes; ++i) {
+      free(watcher->changes[i].path);
+    }
+
+    for (size_t i = 0; i < watcher->n_dirs; ++i) {
+      free(watcher->dirs[i].path);
+    }
+
+    close(watcher->fd);
+    free(watcher->changes);
+    free(watcher->dirs);
+    free(watcher);
+  }
+}
+
+int
+lilv_world_watch(LilvWorld* world)
+{
+  if (world->watcher) {
+    return world->watcher->fd;
+  }
+
+  const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    LILV_ERRORF("Failed to initialize inotify (%s)\n", strerror(errno));
+    return -1;
+  }
+
+  LilvWatcher* const watcher = (LilvWatcher*)calloc(1, sizeof(LilvWatcher));
+  watcher->fd                = fd;
+
+  lilv_lv2_path_for_each(lilv_world_lv2_path(world), watcher, watch_lv2_dir);
+
+  world->watcher = watcher;
+  return fd;
+}
+
+int
+lilv_world_process_changes(LilvWorld* world)
+{
+  LilvWatcher* const watcher = world->watcher;
+  if (!watcher) {
+    return 0;
+  }
+
+  lilv_watcher_read(watcher);
+
+  if (watcher->overflowed) {
+    if (lilv_watch_now_ms() - watcher->overflow_ms < LILV_WATCH_DELAY_MS) {
+      return 0;
+    }
+
+    // Watch any new bundles that were missed, and rescan everything
+    for (size_t i = 0; i < watcher->n_changes; ++i) {
+      free(watcher->changes[i].path);
+    }
+
+    watcher->n_changes  = 0U;
+    watcher->overflowed = false;
+    lilv_lv2_path_for_each(lilv_world_lv2_path(world), watcher, watch_lv2_dir);
+    return lilv_world_rescan(world);
+  }
+
+  // Collect bundles that have been quiet for long enough
+  const uint64_t now    = lilv_watch_now_ms();
+  LilvNode**     uris   = NULL;
+  size_t         n_uris = 0U;
+  for (size_t i = 0; i < watcher->n_changes;) {
+    LilvWatchChange* const change = &watcher->changes[i];
+    if (now - change->time_ms < LILV_WATCH_DELAY_MS) {
+      ++i;
+      continue;
+    }
+
+    SerdNode suri =
+      serd_node_new_file_uri((const uint8_t*)change->path, 0, 0, true);
+
+    uris = (LilvNode**)realloc(uris, ++n_uris * sizeof(LilvNode*));
+    uris[n_uris - 1] = lilv_new_uri(world, (const char*)suri.buf);
+
+    serd_node_free(&suri);
+    free(change->path);
+    *change = watcher->changes[--watcher->n_changes];
+  }
+
+  const int n_changed = lilv_world_refresh_bundles(world, uris, n_uris, true);
+
+  for (size_t i = 0; i < n_uris; ++i) {
+    lilv_node_free(uris[i]);
+  }
+
+  free(uris);
+  return n_changed;
+}
+
+#else // !USE_INOTIFY
+
+void
+lilv_watcher_free(LilvWatcher* watcher)
+{
+  (void)watcher;
+}
+
+int
+lilv_world_watch(LilvWorld* world)
+{
+  (void)world;
+  return -1;
+}
+
+int
+lilv_world_process_changes(LilvWorld* world)
+{
+  (void)world;
+  return 0;
+}
+
+#endif // USE_INOTIFY
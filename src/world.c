@@ -22,10 +22,15 @@
 #include "serd/serd.h"
 #include "sord/sord.h"
 #include "zix/common.h"
+#include "zix/hash.h"
 #include "zix/tree.h"
 
+#include "lv2/atom/atom.h"
 #include "lv2/core/lv2.h"
+#include "lv2/event/event.h"
+#include "lv2/port-props/port-props.h"
 #include "lv2/presets/presets.h"
+#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #  include "lv2/dynmanifest/dynmanifest.h"
@@ -33,15 +38,149 @@
 #endif
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/** Standard port class URIs, in LilvPortClassFlag bit order. */
+static const char* const port_class_uris[LILV_N_PORT_CLASSES] = {
+  LV2_CORE__InputPort,
+  LV2_CORE__OutputPort,
+  LV2_CORE__ControlPort,
+  LV2_CORE__AudioPort,
+  LV2_CORE__CVPort,
+  LV2_ATOM__AtomPort,
+  LV2_EVENT__EventPort,
+};
+
+/** Standard port property URIs, in LilvPortPropertyFlag bit order. */
+static const char* const port_property_uris[LILV_N_PORT_PROPERTIES] = {
+  LV2_CORE__connectionOptional,
+  LV2_CORE__enumeration,
+  LV2_CORE__integer,
+  LV2_CORE__isSideChain,
+  LV2_CORE__reportsLatency,
+  LV2_CORE__sampleRate,
+  LV2_CORE__toggled,
+  LV2_PORT_PROPS__causesArtifacts,
+  LV2_PORT_PROPS__expensive,
+  LV2_PORT_PROPS__hasStrictBounds,
+  LV2_PORT_PROPS__logarithmic,
+  LV2_PORT_PROPS__notAutomatic,
+  LV2_PORT_PROPS__notOnGUI,
+  LV2_PORT_PROPS__trigger,
+};
+
 static int
 lilv_world_drop_graph(LilvWorld* world, const SordNode* graph);
 
+static int
+lilv_world_unload_file(LilvWorld* world, const LilvNode* file);
+
+/** Hash an object with a LilvHeader by the address of its (interned) URI. */
+static uint32_t
+lilv_header_hash(const void* value)
+{
+  const struct LilvHeader* const header =
+    *(const struct LilvHeader* const*)value;
+
+  const SordNode* const node = header->uri->node;
+
+  return (uint32_t)lilv_hash_bytes(&node, sizeof(node));
+}
+
+static bool
+lilv_header_equals(const void* a, const void* b)
+{
+  const struct LilvHeader* const header_a = *(const struct LilvHeader* const*)a;
+  const struct LilvHeader* const header_b = *(const struct LilvHeader* const*)b;
+
+  return header_a->uri->node == header_b->uri->node;
+}
+
+static ZixHash*
+lilv_header_index_new(void)
+{
+  return zix_hash_new(
+    lilv_header_hash, lilv_header_equals, sizeof(struct LilvHeader*));
+}
+
+/** Insert `plugin` into `plugins` and its index. */
+static ZixStatus
+lilv_plugins_insert(LilvPlugins* plugins, ZixHash* index, LilvPlugin* plugin)
+{
+  const ZixStatus st = zix_tree_insert((ZixTree*)plugins, plugin, NULL);
+  if (!st) {
+    zix_hash_insert(index, &plugin, NULL);
+  }
+
+  return st;
+}
+
+/** Remove the plugin at `i` from `plugins` and its index. */
+static void
+lilv_plugins_remove(LilvPlugins* plugins, ZixHash* index, ZixTreeIter* i)
+{
+  const void* const plugin = zix_tree_get(i);
+
+  zix_hash_remove(index, &plugin);
+  zix_tree_remove((ZixTree*)plugins, i);
+}
+
+/** An entry in the index of replaced plugins. */
+typedef struct {
+  SordNode*   uri;    ///< URI of replaced plugin
+  LilvPlugin* plugin; ///< Loaded plugin that replaces it
+} LilvReplacement;
+
+static uint32_t
+lilv_replacement_hash(const void* value)
+{
+  const SordNode* const uri = ((const LilvReplacement*)value)->uri;
+
+  return (uint32_t)lilv_hash_bytes(&uri, sizeof(uri));
+}
+
+static bool
+lilv_replacement_equals(const void* a, const void* b)
+{
+  return ((const LilvReplacement*)a)->uri == ((const LilvReplacement*)b)->uri;
+}
+
+static ZixHash*
+lilv_replacement_index_new(void)
+{
+  return zix_hash_new(
+    lilv_replacement_hash, lilv_replacement_equals, sizeof(LilvReplacement));
+}
+
+static void
+free_replacement_uri(void* value, void* user_data)
+{
+  sord_node_free((SordWorld*)user_data, ((LilvReplacement*)value)->uri);
+}
+
+static void
+lilv_replacement_index_free(LilvWorld* world, ZixHash* index)
+{
+  if (index) {
+    zix_hash_foreach(index, free_replacement_uri, world->world);
+    zix_hash_free(index);
+  }
+}
+
+static void
+lilv_bundle_free(LilvBundle* bundle)
+{
+  lilv_nodes_free(bundle->files);
+  lilv_node_free(bundle->uri);
+  free(bundle->plugins);
+  free(bundle);
+}
+
 LilvWorld*
 lilv_world_new(void)
 {
@@ -57,13 +196,25 @@ lilv_world_new(void)
     goto fail;
   }
 
+  world->nodes       = lilv_node_pool_new();
+  world->feature_ids = lilv_feature_registry_new();
+
   world->specs          = NULL;
   world->plugin_classes = lilv_plugin_classes_new();
   world->plugins        = lilv_plugins_new();
   world->zombies        = lilv_plugins_new();
+  world->plugin_index   = lilv_header_index_new();
+  world->zombie_index   = lilv_header_index_new();
+  world->class_index    = lilv_header_index_new();
+  world->replacements   = lilv_replacement_index_new();
   world->loaded_files   = zix_tree_new(
     false, lilv_resource_node_cmp, NULL, (ZixDestroyFunc)lilv_node_free);
 
+  world->bundles = zix_tree_new(false,
+                                lilv_header_compare_by_uri,
+                                NULL,
+                                (ZixDestroyFunc)lilv_bundle_free);
+
   world->libs = zix_tree_new(false, lilv_lib_compare, NULL, NULL);
 
 #define NS_DCTERMS "http://purl.org/dc/terms/"
@@ -72,9 +223,15 @@ lilv_world_new(void)
 
 #define NEW_URI(uri) sord_new_uri(world->world, (const uint8_t*)(uri))
 
+  world->uris.atom_supports       = NEW_URI(LV2_ATOM__supports);
   world->uris.dc_replaces         = NEW_URI(NS_DCTERMS "replaces");
   world->uris.dman_DynManifest    = NEW_URI(NS_DYNMAN "DynManifest");
+  world->uris.doap_maintainer     = NEW_URI(LILV_NS_DOAP "maintainer");
   world->uris.doap_name           = NEW_URI(LILV_NS_DOAP "name");
+  world->uris.ev_supportsEvent    = NEW_URI(LV2_EVENT__supportsEvent);
+  world->uris.foaf_homepage       = NEW_URI(LILV_NS_FOAF "homepage");
+  world->uris.foaf_mbox           = NEW_URI(LILV_NS_FOAF "mbox");
+  world->uris.foaf_name           = NEW_URI(LILV_NS_FOAF "name");
   world->uris.lv2_Plugin          = NEW_URI(LV2_CORE__Plugin);
   world->uris.lv2_Specification   = NEW_URI(LV2_CORE__Specification);
   world->uris.lv2_appliesTo       = NEW_URI(LV2_CORE__appliesTo);
@@ -92,8 +249,10 @@ lilv_world_new(void)
   world->uris.lv2_optionalFeature = NEW_URI(LV2_CORE__optionalFeature);
   world->uris.lv2_port            = NEW_URI(LV2_CORE__port);
   world->uris.lv2_portProperty    = NEW_URI(LV2_CORE__portProperty);
+  world->uris.lv2_project         = NEW_URI(LV2_CORE__project);
   world->uris.lv2_reportsLatency  = NEW_URI(LV2_CORE__reportsLatency);
   world->uris.lv2_requiredFeature = NEW_URI(LV2_CORE__requiredFeature);
+  world->uris.lv2_scalePoint      = NEW_URI(LV2_CORE__scalePoint);
   world->uris.lv2_symbol          = NEW_URI(LV2_CORE__symbol);
   world->uris.lv2_prototype       = NEW_URI(LV2_CORE__prototype);
   world->uris.owl_Ontology        = NEW_URI(NS_OWL "Ontology");
@@ -104,6 +263,8 @@ lilv_world_new(void)
   world->uris.rdfs_label          = NEW_URI(LILV_NS_RDFS "label");
   world->uris.rdfs_seeAlso        = NEW_URI(LILV_NS_RDFS "seeAlso");
   world->uris.rdfs_subClassOf     = NEW_URI(LILV_NS_RDFS "subClassOf");
+  world->uris.ui_binary           = NEW_URI(LV2_UI__binary);
+  world->uris.ui_ui               = NEW_URI(LV2_UI__ui);
   world->uris.xsd_base64Binary    = NEW_URI(LILV_NS_XSD "base64Binary");
   world->uris.xsd_boolean         = NEW_URI(LILV_NS_XSD "boolean");
   world->uris.xsd_decimal         = NEW_URI(LILV_NS_XSD "decimal");
@@ -111,13 +272,32 @@ lilv_world_new(void)
   world->uris.xsd_integer         = NEW_URI(LILV_NS_XSD "integer");
   world->uris.null_uri            = NULL;
 
+  for (unsigned i = 0U; i < LILV_N_PORT_CLASSES; ++i) {
+    world->port_classes[i] = NEW_URI(port_class_uris[i]);
+  }
+
+  for (unsigned i = 0U; i < LILV_N_PORT_PROPERTIES; ++i) {
+    world->port_properties[i] = NEW_URI(port_property_uris[i]);
+  }
+
   world->lv2_plugin_class =
     lilv_plugin_class_new(world, NULL, world->uris.lv2_Plugin, "Plugin");
   assert(world->lv2_plugin_class);
 
-  world->n_read_files        = 0;
-  world->opt.filter_language = true;
-  world->opt.dyn_manifest    = true;
+  zix_sem_init(&world->node_lock, 1);
+  zix_sem_init(&world->libs_lock, 1);
+
+#ifdef LILV_TRACE
+  const char* const trace_path = getenv("LILV_TRACE_FILE");
+  if (trace_path && trace_path[0]) {
+    world->trace = lilv_trace_new(trace_path);
+  }
+#endif
+
+  world->n_read_files          = 0;
+  world->opt.filter_language   = true;
+  world->opt.dyn_manifest      = true;
+  world->opt.discovery_threads = 1;
 
   return world;
 
@@ -126,6 +306,15 @@ fail:
   return NULL;
 }
 
+static void
+lilv_spec_free(LilvWorld* world, LilvSpec* spec)
+{
+  sord_node_free(world->world, spec->spec);
+  sord_node_free(world->world, spec->bundle);
+  lilv_nodes_free(spec->data_uris);
+  free(spec);
+}
+
 void
 lilv_world_free(LilvWorld* world)
 {
@@ -140,12 +329,17 @@ lilv_world_free(LilvWorld* world)
     sord_node_free(world->world, *n);
   }
 
+  for (unsigned i = 0U; i < LILV_N_PORT_CLASSES; ++i) {
+    sord_node_free(world->world, world->port_classes[i]);
+  }
+
+  for (unsigned i = 0U; i < LILV_N_PORT_PROPERTIES; ++i) {
+    sord_node_free(world->world, world->port_properties[i]);
+  }
+
   for (LilvSpec* spec = world->specs; spec;) {
     LilvSpec* next = spec->next;
-    sord_node_free(world->world, spec->spec);
-    sord_node_free(world->world, spec->bundle);
-    lilv_nodes_free(spec->data_uris);
-    free(spec);
+    lilv_spec_free(world, spec);
     spec = next;
   }
   world->specs = NULL;
@@ -164,22 +358,65 @@ lilv_world_free(LilvWorld* world)
   zix_tree_free((ZixTree*)world->zombies);
   world->zombies = NULL;
 
-  zix_tree_free((ZixTree*)world->loaded_files);
+  zix_hash_free(world->zombie_index);
+  world->zombie_index = NULL;
+
+  lilv_replacement_index_free(world, world->replacements);
+  world->replacements = NULL;
+
+  zix_hash_free(world->plugin_index);
+  world->plugin_index = NULL;
+
+  zix_tree_free(world->loaded_files);
   world->loaded_files = NULL;
 
+  zix_tree_free(world->bundles);
+  world->bundles = NULL;
+
+  lilv_watcher_free(world->watcher);
+  world->watcher = NULL;
+
+  lilv_lib_release_preloaded(world);
+  lilv_lib_trim(world, 0U);
+  free(world->idle_libs);
+  world->idle_libs = NULL;
+
   zix_tree_free(world->libs);
   world->libs = NULL;
 
-  zix_tree_free((ZixTree*)world->plugin_classes);
+  lilv_plugin_classes_free(world->plugin_classes);
   world->plugin_classes = NULL;
 
+  zix_hash_free(world->class_index);
+  world->class_index = NULL;
+
+  zix_hash_free(world->nodes);
+  world->nodes = NULL;
+
+  for (uint32_t i = 0U; i < world->n_features; ++i) {
+    sord_node_free(world->world, world->feature_uris[i]);
+  }
+
+  zix_hash_free(world->feature_ids);
+  free(world->feature_uris);
+  world->feature_ids  = NULL;
+  world->feature_uris = NULL;
+
   sord_free(world->model);
   world->model = NULL;
 
   sord_world_free(world->world);
   world->world = NULL;
 
+  lilv_arena_clear(&world->arena);
+
+  free(world->opt.cache_dir);
   free(world->opt.lv2_path);
+  zix_sem_destroy(&world->libs_lock);
+  zix_sem_destroy(&world->node_lock);
+#ifdef LILV_TRACE
+  lilv_trace_free(world->trace);
+#endif
   free(world);
 }
 
@@ -198,9 +435,42 @@ lilv_world_set_option(LilvWorld* world, const char* uri, const LilvNode* value)
     }
   } else if (!strcmp(uri, LILV_OPTION_LV2_PATH)) {
     if (lilv_node_is_string(value)) {
+      free(world->opt.lv2_path);
       world->opt.lv2_path = lilv_strdup(lilv_node_as_string(value));
       return;
     }
+  } else if (!strcmp(uri, LILV_OPTION_CACHE_DIR)) {
+    if (lilv_node_is_string(value)) {
+      free(world->opt.cache_dir);
+      world->opt.cache_dir = lilv_strdup(lilv_node_as_string(value));
+      return;
+    }
+  } else if (!strcmp(uri, LILV_OPTION_DISCOVERY_THREADS)) {
+    if (lilv_node_is_int(value) && lilv_node_as_int(value) >= 0) {
+      world->opt.discovery_threads = (unsigned)lilv_node_as_int(value);
+      return;
+    }
+  } else if (!strcmp(uri, LILV_OPTION_KEEP_LIBRARIES)) {
+    if (lilv_node_is_int(value) && lilv_node_as_int(value) >= 0) {
+      world->opt.keep_libraries = (unsigned)lilv_node_as_int(value);
+      lilv_lib_trim(world, world->opt.keep_libraries);
+      return;
+    }
+  } else if (!strcmp(uri, LILV_OPTION_STATS)) {
+    if (lilv_node_is_bool(value)) {
+      world->opt.stats = lilv_node_as_bool(value);
+      return;
+    }
+  } else if (!strcmp(uri, LILV_OPTION_TRACE_FILE)) {
+    if (lilv_node_is_string(value)) {
+#ifdef LILV_TRACE
+      lilv_trace_free(world->trace);
+      world->trace = lilv_trace_new(lilv_node_as_string(value));
+#else
+      LILV_WARN("Trace support is not enabled\n");
+#endif
+      return;
+    }
   }
   LILV_WARNF("Unrecognized or invalid option `%s'\n", uri);
 }
@@ -228,6 +498,8 @@ lilv_world_find_nodes(LilvWorld*      world,
     return NULL;
   }
 
+  lilv_world_ensure_specifications(world);
+
   if (!subject && !object) {
     LILV_ERROR("Both subject and object are NULL\n");
     return NULL;
@@ -239,19 +511,48 @@ lilv_world_find_nodes(LilvWorld*      world,
                                         object ? object->node : NULL);
 }
 
+/**
+   Return the first node matching the wildcard in a pattern.
+
+   Unlike sord_get(), this does not copy any SordNode, so the result is only
+   referenced once, by the returned LilvNode.
+*/
+static LilvNode*
+lilv_world_get_node(LilvWorld*      world,
+                    const SordNode* subject,
+                    const SordNode* predicate,
+                    const SordNode* object)
+{
+  const SordQuadIndex field =
+    !subject ? SORD_SUBJECT : !predicate ? SORD_PREDICATE : SORD_OBJECT;
+
+  SordIter* const i =
+    lilv_world_query_internal(world, subject, predicate, object);
+
+  LilvNode* const result =
+    sord_iter_end(i)
+      ? NULL
+      : lilv_node_new_from_node(world, sord_iter_get_node(i, field));
+
+  lilv_world_iter_free(world, i);
+  return result;
+}
+
 LilvNode*
 lilv_world_get(LilvWorld*      world,
                const LilvNode* subject,
                const LilvNode* predicate,
                const LilvNode* object)
 {
+  lilv_world_ensure_specifications(world);
+
   if (!object) {
     // TODO: Improve performance (see lilv_plugin_get_one)
-    SordIter* stream = sord_search(world->model,
-                                   subject ? subject->node : NULL,
-                                   predicate ? predicate->node : NULL,
-                                   NULL,
-                                   NULL);
+    SordIter* stream =
+      lilv_world_query_internal(world,
+                                subject ? subject->node : NULL,
+                                predicate ? predicate->node : NULL,
+                                NULL);
 
     LilvNodes* nodes =
       lilv_nodes_from_stream_objects(world, stream, SORD_OBJECT);
@@ -265,14 +566,110 @@ lilv_world_get(LilvWorld*      world,
     return NULL;
   }
 
-  SordNode* snode = sord_get(world->model,
+  return lilv_world_get_node(world,
                              subject ? subject->node : NULL,
                              predicate ? predicate->node : NULL,
-                             object ? object->node : NULL,
-                             NULL);
-  LilvNode* lnode = lilv_node_new_from_node(world, snode);
-  sord_node_free(world->world, snode);
-  return lnode;
+                             object->node);
+}
+
+void
+lilv_world_count_file(LilvWorld* world,
+                      bool       cached,
+                      uint64_t   n_bytes,
+                      uint64_t   read_us)
+{
+  if (world->opt.stats) {
+    if (cached) {
+      ++world->stats.n_files_cached;
+    } else {
+      ++world->stats.n_files_parsed;
+    }
+
+    world->stats.n_bytes_read += n_bytes;
+    world->stats.read_time_us += read_us;
+  }
+}
+
+LilvWorldStats
+lilv_world_get_stats(const LilvWorld* world)
+{
+  LilvWorldStats stats = world->stats;
+
+  stats.n_triples = sord_num_quads(world->model);
+  return stats;
+}
+
+/** The number of statements in a graph, for printing statistics. */
+typedef struct {
+  const SordNode* graph;
+  uint64_t        n_triples;
+} LilvGraphCount;
+
+static uint32_t
+lilv_graph_count_hash(const void* value)
+{
+  const SordNode* const graph = ((const LilvGraphCount*)value)->graph;
+
+  return (uint32_t)lilv_hash_bytes(&graph, sizeof(graph));
+}
+
+static bool
+lilv_graph_count_equals(const void* a, const void* b)
+{
+  return ((const LilvGraphCount*)a)->graph == ((const LilvGraphCount*)b)->graph;
+}
+
+static void
+print_graph_count(void* value, void* user_data)
+{
+  const LilvGraphCount* const count = (const LilvGraphCount*)value;
+
+  fprintf((FILE*)user_data,
+          "%10" PRIu64 "  %s\n",
+          count->n_triples,
+          count->graph ? (const char*)sord_node_get_string(count->graph)
+                       : "(default graph)");
+}
+
+void
+lilv_world_print_stats(const LilvWorld* world, FILE* stream)
+{
+  const LilvWorldStats stats = lilv_world_get_stats(world);
+
+  fprintf(stream, "Files parsed:       %" PRIu64 "\n", stats.n_files_parsed);
+  fprintf(stream, "Files cached:       %" PRIu64 "\n", stats.n_files_cached);
+  fprintf(stream, "Bytes read:         %" PRIu64 "\n", stats.n_bytes_read);
+  fprintf(stream, "Read time (us):     %" PRIu64 "\n", stats.read_time_us);
+  fprintf(stream, "Triples:            %" PRIu64 "\n", stats.n_triples);
+  fprintf(stream, "Bundles loaded:     %" PRIu64 "\n", stats.n_bundles_loaded);
+  fprintf(
+    stream, "Version conflicts:  %" PRIu64 "\n", stats.n_version_conflicts);
+  fprintf(stream, "Plugin loads:       %" PRIu64 "\n", stats.n_plugin_loads);
+  fprintf(stream, "Port tables:        %" PRIu64 "\n", stats.n_port_tables);
+  fprintf(stream, "Queries:            %" PRIu64 "\n", stats.n_queries);
+
+  // Count the statements in each graph
+  ZixHash* const counts = zix_hash_new(
+    lilv_graph_count_hash, lilv_graph_count_equals, sizeof(LilvGraphCount));
+
+  SordIter* i = sord_begin(world->model);
+  FOREACH_MATCH (i) {
+    SordQuad quad;
+    sord_iter_get(i, quad);
+
+    const LilvGraphCount  key   = {quad[SORD_GRAPH], 1U};
+    LilvGraphCount* const count = (LilvGraphCount*)zix_hash_find(counts, &key);
+    if (count) {
+      ++count->n_triples;
+    } else {
+      zix_hash_insert(counts, &key, NULL);
+    }
+  }
+  sord_iter_free(i);
+
+  fprintf(stream, "Triples per graph:\n");
+  zix_hash_foreach(counts, print_graph_count, stream);
+  zix_hash_free(counts);
 }
 
 SordIter*
@@ -281,7 +678,26 @@ lilv_world_query_internal(LilvWorld*      world,
                           const SordNode* predicate,
                           const SordNode* object)
 {
-  return sord_search(world->model, subject, predicate, object, NULL);
+  // Creating an iterator modifies the model, as does the counter
+  lilv_world_lock_nodes(world);
+
+  if (world->opt.stats) {
+    ++world->stats.n_queries;
+  }
+
+  SordIter* const iter =
+    sord_search(world->model, subject, predicate, object, NULL);
+
+  lilv_world_unlock_nodes(world);
+  return iter;
+}
+
+void
+lilv_world_iter_free(LilvWorld* world, SordIter* iter)
+{
+  lilv_world_lock_nodes(world);
+  sord_iter_free(iter);
+  lilv_world_unlock_nodes(world);
 }
 
 bool
@@ -290,7 +706,12 @@ lilv_world_ask_internal(LilvWorld*      world,
                         const SordNode* predicate,
                         const SordNode* object)
 {
-  return sord_ask(world->model, subject, predicate, object, NULL);
+  lilv_world_lock_nodes(world);
+
+  const bool result = sord_ask(world->model, subject, predicate, object, NULL);
+
+  lilv_world_unlock_nodes(world);
+  return result;
 }
 
 bool
@@ -299,11 +720,12 @@ lilv_world_ask(LilvWorld*      world,
                const LilvNode* predicate,
                const LilvNode* object)
 {
-  return sord_ask(world->model,
-                  subject ? subject->node : NULL,
-                  predicate ? predicate->node : NULL,
-                  object ? object->node : NULL,
-                  NULL);
+  lilv_world_ensure_specifications(world);
+
+  return lilv_world_ask_internal(world,
+                                 subject ? subject->node : NULL,
+                                 predicate ? predicate->node : NULL,
+                                 object ? object->node : NULL);
 }
 
 SordModel*
@@ -388,23 +810,88 @@ lilv_lib_compare(const void* a, const void* b, const void* user_data)
   return cmp ? cmp : strcmp(lib_a->bundle_path, lib_b->bundle_path);
 }
 
-/** Get an element of a collection of any object with an LilvHeader by URI. */
+/** Find an element of a tree of any object with an LilvHeader by URI. */
 static ZixTreeIter*
-lilv_collection_find_by_uri(const ZixTree* seq, const LilvNode* uri)
+lilv_tree_find_by_uri(const ZixTree* tree, const LilvNode* uri)
 {
   ZixTreeIter* i = NULL;
   if (lilv_node_is_uri(uri)) {
     struct LilvHeader key = {NULL, (LilvNode*)uri};
-    zix_tree_find(seq, &key, &i);
+    zix_tree_find(tree, &key, &i);
   }
   return i;
 }
 
+/** Return the hash index for a collection in `world`, or NULL. */
+static const ZixHash*
+lilv_world_get_index(const LilvWorld* world, const void* seq)
+{
+  if (seq == world->plugins) {
+    return world->plugin_index;
+  }
+
+  if (seq == world->zombies) {
+    return world->zombie_index;
+  }
+
+  if (seq == world->plugin_classes) {
+    return world->class_index;
+  }
+
+  return NULL;
+}
+
+/**
+   Find an object with a LilvHeader by URI in a world index.
+
+   The world's own collections are indexed by URI node, which is the same
+   object for equal URIs since nodes are interned, so this is faster than a
+   search that compares URI strings.
+*/
+static struct LilvHeader*
+lilv_index_find(const ZixHash* index, const LilvNode* uri)
+{
+  const struct LilvHeader        key     = {NULL, (LilvNode*)uri};
+  const struct LilvHeader* const key_ptr = &key;
+  const struct LilvHeader* const* const found =
+    (const struct LilvHeader* const*)zix_hash_find(index, &key_ptr);
+
+  return found ? (struct LilvHeader*)*found : NULL;
+}
+
 /** Get an element of a collection of any object with an LilvHeader by URI. */
 struct LilvHeader*
-lilv_collection_get_by_uri(const ZixTree* seq, const LilvNode* uri)
+lilv_collection_get_by_uri(const LilvCollection* collection,
+                           const LilvNode*       uri)
+{
+  if (!lilv_node_is_uri(uri)) {
+    return NULL;
+  }
+
+  const ZixHash* const index = lilv_world_get_index(uri->world, collection);
+  if (index) {
+    return lilv_index_find(index, uri);
+  }
+
+  const struct LilvHeader key = {NULL, (LilvNode*)uri};
+
+  return (struct LilvHeader*)lilv_collection_find(collection, &key);
+}
+
+/** Get an element of a tree of any object with an LilvHeader by URI. */
+struct LilvHeader*
+lilv_tree_get_by_uri(const ZixTree* tree, const LilvNode* uri)
 {
-  ZixTreeIter* const i = lilv_collection_find_by_uri(seq, uri);
+  if (!lilv_node_is_uri(uri)) {
+    return NULL;
+  }
+
+  const ZixHash* const index = lilv_world_get_index(uri->world, tree);
+  if (index) {
+    return lilv_index_find(index, uri);
+  }
+
+  ZixTreeIter* const i = lilv_tree_find_by_uri(tree, uri);
 
   return i ? (struct LilvHeader*)zix_tree_get(i) : NULL;
 }
@@ -424,9 +911,8 @@ lilv_world_add_spec(LilvWorld*      world,
     world->model, specification_node, world->uris.rdfs_seeAlso, NULL, NULL);
   FOREACH_MATCH (files) {
     const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-    zix_tree_insert((ZixTree*)spec->data_uris,
-                    lilv_node_new_from_node(world, file_node),
-                    NULL);
+    lilv_collection_insert(spec->data_uris,
+                           lilv_node_new_from_node(world, file_node));
   }
   sord_iter_free(files);
 
@@ -435,6 +921,90 @@ lilv_world_add_spec(LilvWorld*      world,
   world->specs = spec;
 }
 
+/** Return the record for a bundle, creating one if necessary. */
+static LilvBundle*
+lilv_world_get_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+  LilvBundle* bundle =
+    (LilvBundle*)lilv_tree_get_by_uri(world->bundles, bundle_uri);
+
+  if (!bundle) {
+    bundle        = (LilvBundle*)calloc(1, sizeof(LilvBundle));
+    bundle->world = world;
+    bundle->uri   = lilv_node_duplicate(bundle_uri);
+    zix_tree_insert(world->bundles, bundle, NULL);
+  }
+
+  return bundle;
+}
+
+static void
+lilv_bundle_add_plugin(LilvBundle* bundle, LilvPlugin* plugin)
+{
+  bundle->plugins = (LilvPlugin**)realloc(
+    bundle->plugins, ++bundle->n_plugins * sizeof(LilvPlugin*));
+
+  bundle->plugins[bundle->n_plugins - 1] = plugin;
+}
+
+/**
+   Return the recorded bundle that a loaded file belongs to, or NULL.
+
+   This is the bundle whose graph the file was loaded into, or otherwise, the
+   bundle directory that contains the file.
+*/
+static LilvBundle*
+lilv_world_find_file_bundle(LilvWorld*      world,
+                            const SordNode* graph,
+                            const LilvNode* uri)
+{
+  LilvBundle* bundle = NULL;
+  if (graph) {
+    LilvNode* const graph_uri = lilv_node_new_from_node(world, graph);
+
+    bundle = (LilvBundle*)lilv_tree_get_by_uri(world->bundles, graph_uri);
+    lilv_node_free(graph_uri);
+    if (bundle) {
+      return bundle;
+    }
+  }
+
+  // Try every parent directory (with trailing slash) from the bottom up
+  char* const       dir  = lilv_strdup(lilv_node_as_uri(uri));
+  const char* const root = strstr(dir, "://");
+  char*             s    = strrchr(dir, '/');
+  while (!bundle && root && s > root + 2) {
+    s[1] = '\0';
+
+    LilvNode* const dir_uri = lilv_new_uri(world, dir);
+    bundle = (LilvBundle*)lilv_tree_get_by_uri(world->bundles, dir_uri);
+    lilv_node_free(dir_uri);
+
+    s[0] = '\0';
+    s    = strrchr(dir, '/');
+  }
+
+  free(dir);
+  return bundle;
+}
+
+void
+lilv_world_add_loaded_file(LilvWorld*      world,
+                           const SordNode* graph,
+                           const LilvNode* uri)
+{
+  zix_tree_insert(world->loaded_files, lilv_node_duplicate(uri), NULL);
+
+  LilvBundle* const bundle = lilv_world_find_file_bundle(world, graph, uri);
+  if (bundle) {
+    if (!bundle->files) {
+      bundle->files = lilv_nodes_new();
+    }
+
+    lilv_collection_insert(bundle->files, lilv_node_duplicate(uri));
+  }
+}
+
 static void
 lilv_world_add_plugin(LilvWorld*      world,
                       const SordNode* plugin_node,
@@ -465,25 +1035,29 @@ lilv_world_add_plugin(LilvWorld*      world,
       lilv_node_free(plugin_uri);
       return;
     }
-  } else if ((z = lilv_collection_find_by_uri((const ZixTree*)world->zombies,
-                                              plugin_uri))) {
+  } else if ((z = lilv_tree_find_by_uri((const ZixTree*)world->zombies,
+                                        plugin_uri))) {
     // Plugin bundle has been re-loaded, move from zombies to plugins
     plugin = (LilvPlugin*)zix_tree_get(z);
-    zix_tree_remove((ZixTree*)world->zombies, z);
-    zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+    lilv_plugins_remove(world->zombies, world->zombie_index, z);
+    lilv_plugins_insert(world->plugins, world->plugin_index, plugin);
     lilv_node_free(plugin_uri);
     lilv_plugin_clear(plugin, lilv_node_new_from_node(world, bundle));
+    lilv_bundle_add_plugin(lilv_world_get_bundle(world, plugin->bundle_uri),
+                           plugin);
   } else {
     // Add new plugin to the world
     plugin = lilv_plugin_new(
       world, plugin_uri, lilv_node_new_from_node(world, bundle));
 
     // Add manifest as plugin data file (as if it were rdfs:seeAlso)
-    zix_tree_insert(
-      (ZixTree*)plugin->data_uris, lilv_node_duplicate(manifest_uri), NULL);
+    lilv_collection_insert(plugin->data_uris,
+                           lilv_node_duplicate(manifest_uri));
 
     // Add plugin to world plugin sequence
-    zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+    lilv_plugins_insert(world->plugins, world->plugin_index, plugin);
+    lilv_bundle_add_plugin(lilv_world_get_bundle(world, plugin->bundle_uri),
+                           plugin);
   }
 
 #ifdef LILV_DYN_MANIFEST
@@ -499,9 +1073,8 @@ lilv_world_add_plugin(LilvWorld*      world,
     world->model, plugin_node, world->uris.rdfs_seeAlso, NULL, NULL);
   FOREACH_MATCH (files) {
     const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-    zix_tree_insert((ZixTree*)plugin->data_uris,
-                    lilv_node_new_from_node(world, file_node),
-                    NULL);
+    lilv_collection_insert(plugin->data_uris,
+                           lilv_node_new_from_node(world, file_node));
   }
   sord_iter_free(files);
 }
@@ -509,15 +1082,57 @@ lilv_world_add_plugin(LilvWorld*      world,
 SerdStatus
 lilv_world_load_graph(LilvWorld* world, SordNode* graph, const LilvNode* uri)
 {
-  const SerdNode* base = sord_node_to_serd_node(uri->node);
-  SerdEnv*        env  = serd_env_new(base);
-  SerdReader* reader   = sord_new_reader(world->model, env, SERD_TURTLE, graph);
+  ZixTreeIter* iter = NULL;
+  if (!zix_tree_find(world->loaded_files, uri, &iter)) {
+    return SERD_FAILURE; // File has already been loaded
+  }
+
+  size_t               uri_len = 0;
+  const uint8_t* const uri_str =
+    sord_node_get_string_counted(uri->node, &uri_len);
+  if (strncmp((const char*)uri_str, "file:", 5)) {
+    return SERD_FAILURE; // Not a local file
+  }
+
+  if (strcmp((const char*)uri_str + uri_len - 4, ".ttl")) {
+    return SERD_FAILURE; // Not a Turtle file
+  }
 
-  const SerdStatus st = lilv_world_load_file(world, reader, uri);
+  const uint8_t* const prefix = lilv_world_blank_node_prefix(world);
+  const uint64_t       start  = world->opt.stats ? lilv_time_us() : 0U;
+  SerdStatus           st     = SERD_SUCCESS;
+  bool                 cached = false;
+  if (world->opt.cache_dir) {
+    st = lilv_cache_load_file(world->opt.cache_dir,
+                              world->model,
+                              graph,
+                              (const char*)uri_str,
+                              prefix,
+                              &cached);
+  } else {
+    SerdEnv*    env    = serd_env_new(sord_node_to_serd_node(uri->node));
+    SerdReader* reader = sord_new_reader(world->model, env, SERD_TURTLE, graph);
 
-  serd_env_free(env);
-  serd_reader_free(reader);
-  return st;
+    serd_reader_add_blank_prefix(reader, prefix);
+    st = serd_reader_read_file(reader, uri_str);
+    serd_reader_free(reader);
+    serd_env_free(env);
+  }
+
+  if (st) {
+    LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(uri));
+    return st;
+  }
+
+  if (world->opt.stats) {
+    lilv_world_count_file(world,
+                          cached,
+                          lilv_file_uri_size((const char*)uri_str),
+                          lilv_time_us() - start);
+  }
+
+  lilv_world_add_loaded_file(world, graph, uri);
+  return SERD_SUCCESS;
 }
 
 static void
@@ -681,114 +1296,204 @@ lilv_world_get_manifest_uri(LilvWorld* world, const LilvNode* bundle_uri)
   return manifest;
 }
 
-static SordModel*
-load_plugin_model(LilvWorld*      world,
-                  const LilvNode* bundle_uri,
-                  const LilvNode* plugin_uri)
+/** Get the version of `subject` in the graph `bundle`, if it is there. */
+static bool
+get_version(LilvWorld*      world,
+            const SordNode* bundle,
+            const SordNode* subject,
+            LilvVersion*    version)
 {
-  // Create model and reader for loading into it
-  SordNode*   bundle_node = bundle_uri->node;
-  SordModel*  model       = sord_new(world->world, SORD_SPO | SORD_OPS, false);
-  SerdEnv*    env         = serd_env_new(sord_node_to_serd_node(bundle_node));
-  SerdReader* reader      = sord_new_reader(model, env, SERD_TURTLE, NULL);
-
-  // Load manifest
-  LilvNode* manifest_uri = lilv_world_get_manifest_uri(world, bundle_uri);
-  serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
-  serd_reader_read_file(reader,
-                        (const uint8_t*)lilv_node_as_string(manifest_uri));
+  SordNode* const minor_node = sord_get(
+    world->model, subject, world->uris.lv2_minorVersion, NULL, bundle);
+  SordNode* const micro_node = sord_get(
+    world->model, subject, world->uris.lv2_microVersion, NULL, bundle);
+
+  const bool found = minor_node && micro_node;
+  if (found) {
+    version->minor = atoi((const char*)sord_node_get_string(minor_node));
+    version->micro = atoi((const char*)sord_node_get_string(micro_node));
+  }
 
-  // Load any seeAlso files
-  SordModel* files = lilv_world_filter_model(
-    world, model, plugin_uri->node, world->uris.rdfs_seeAlso, NULL, NULL);
+  sord_node_free(world->world, micro_node);
+  sord_node_free(world->world, minor_node);
+  return found;
+}
 
-  SordIter* f = sord_begin(files);
-  FOREACH_MATCH (f) {
-    const SordNode* file     = sord_iter_get_node(f, SORD_OBJECT);
-    const uint8_t*  file_str = sord_node_get_string(file);
-    if (sord_node_get_type(file) == SORD_URI) {
-      serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
-      serd_reader_read_file(reader, file_str);
-    }
-  }
+/**
+   Return the version of a plugin in a bundle that is loaded into the model.
 
+   The version is usually in the manifest, but if not, the data files of the
+   plugin are loaded into the bundle graph, just as they would be when the
+   plugin is loaded, unless they are already loaded.  Since loaded files are
+   recorded, this reads every file at most once.  Any newly loaded files are
+   added to `new_files`.
+*/
+static LilvVersion
+lilv_world_get_plugin_version(LilvWorld*      world,
+                              const SordNode* bundle,
+                              const SordNode* plugin,
+                              LilvNodes*      new_files)
+{
+  LilvVersion version = {0, 0};
+  if (get_version(world, bundle, plugin, &version)) {
+    return version;
+  }
+
+  // Collect data files first, since loading modifies the model
+  LilvNodes* const files = lilv_nodes_new();
+  SordIter* const  f =
+    sord_search(world->model, plugin, world->uris.rdfs_seeAlso, NULL, bundle);
+  FOREACH_MATCH (f) {
+    const SordNode* const file = sord_iter_get_node(f, SORD_OBJECT);
+    if (sord_node_get_type(file) == SORD_URI) {
+      lilv_collection_insert(files, lilv_node_new_from_node(world, file));
+    }
+  }
   sord_iter_free(f);
-  sord_free(files);
-  serd_reader_free(reader);
-  serd_env_free(env);
-  lilv_node_free(manifest_uri);
 
-  return model;
+  LILV_FOREACH (nodes, i, files) {
+    const LilvNode* const file = lilv_nodes_get(files, i);
+    if (!lilv_world_load_graph(world, (SordNode*)bundle, file) && new_files) {
+      lilv_collection_insert(new_files, lilv_node_duplicate(file));
+    }
+  }
+
+  // Files loaded with lilv_world_load_resource() have their own graph
+  bool found = get_version(world, bundle, plugin, &version);
+  for (LilvIter* i = lilv_nodes_begin(files);
+       !found && !lilv_nodes_is_end(files, i);
+       i = lilv_nodes_next(files, i)) {
+    const LilvNode* const file = lilv_nodes_get(files, i);
+
+    found = get_version(world, file->node, plugin, &version);
+  }
+
+  lilv_nodes_free(files);
+  return version;
 }
 
+/** Return the version of a loaded plugin, which is only looked up once. */
 static LilvVersion
-get_version(LilvWorld* world, SordModel* model, const LilvNode* subject)
+lilv_world_get_loaded_version(LilvWorld* world, LilvPlugin* plugin)
 {
-  const SordNode* minor_node =
-    sord_get(model, subject->node, world->uris.lv2_minorVersion, NULL, NULL);
-  const SordNode* micro_node =
-    sord_get(model, subject->node, world->uris.lv2_microVersion, NULL, NULL);
+  if (!plugin->has_version) {
+    plugin->version     = lilv_world_get_plugin_version(
+      world, plugin->bundle_uri->node, plugin->plugin_uri->node, NULL);
+    plugin->has_version = true;
+  }
 
-  LilvVersion version = {0, 0};
-  if (minor_node && micro_node) {
-    version.minor = atoi((const char*)sord_node_get_string(minor_node));
-    version.micro = atoi((const char*)sord_node_get_string(micro_node));
+  return plugin->version;
+}
+
+static void
+stamp_dir_entry(const char* dir, const char* name, void* data)
+{
+  uint64_t* const stamp = (uint64_t*)data;
+  char* const     path  = lilv_path_join(dir, name);
+  uint64_t        size  = 0U;
+  int64_t         mtime = 0;
+
+  if (!lilv_file_stamp(path, &size, &mtime)) {
+    const uint64_t entry[] = {
+      lilv_hash_bytes(name, strlen(name)), size, (uint64_t)mtime};
+
+    // Sum entry hashes so the result does not depend on directory order
+    *stamp += lilv_hash_bytes(entry, sizeof(entry));
   }
 
-  return version;
+  free(path);
 }
 
-void
-lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+/**
+   Return a stamp that changes when the files in a bundle change.
+
+   This only costs a stat() for the bundle and every file directly in it.
+   Zero is returned if the bundle is not a local directory.
+*/
+static uint64_t
+lilv_bundle_stamp(const LilvNode* bundle_uri)
 {
-  if (!lilv_node_is_uri(bundle_uri)) {
-    LILV_ERRORF("Bundle URI `%s' is not a URI\n",
-                sord_node_get_string(bundle_uri->node));
-    return;
+  char* const path  = lilv_file_uri_parse(lilv_node_as_uri(bundle_uri), NULL);
+  uint64_t    size  = 0U;
+  int64_t     mtime = 0;
+  uint64_t    stamp = 0U;
+
+  if (path && !lilv_file_stamp(path, &size, &mtime)) {
+    stamp = lilv_hash_bytes(&mtime, sizeof(mtime));
+    lilv_dir_for_each(path, &stamp, stamp_dir_entry);
   }
 
+  lilv_free(path);
+  return stamp;
+}
+
+/** Record that a bundle is being loaded, along with its current stamp. */
+static void
+lilv_world_record_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+  lilv_world_get_bundle(world, bundle_uri)->stamp =
+    lilv_bundle_stamp(bundle_uri);
+}
+
+static int
+lilv_world_drop_bundle(LilvWorld* world, const LilvNode* bundle_uri);
+
+/**
+   Add the plugins and specifications in a bundle.
+
+   The manifest must already be loaded into the model with graph = bundle_uri.
+*/
+static void
+lilv_world_add_bundle(LilvWorld*      world,
+                      const LilvNode* bundle_uri,
+                      const LilvNode* manifest)
+{
   SordNode* bundle_node = bundle_uri->node;
-  LilvNode* manifest    = lilv_world_get_manifest_uri(world, bundle_uri);
 
-  // Read manifest into model with graph = bundle_node
-  SerdStatus st = lilv_world_load_graph(world, bundle_node, manifest);
-  if (st > SERD_FAILURE) {
-    LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
-    lilv_node_free(manifest);
-    return;
+  if (world->opt.stats) {
+    ++world->stats.n_bundles_loaded;
   }
 
-  // ?plugin a lv2:Plugin
-  SordIter* plug_results = sord_search(
+  // ?plugin a lv2:Plugin (collected since version checks modify the model)
+  LilvNodes* plugin_uris  = lilv_nodes_new();
+  SordIter*  plug_results = sord_search(
     world->model, NULL, world->uris.rdf_a, world->uris.lv2_Plugin, bundle_node);
+  FOREACH_MATCH (plug_results) {
+    lilv_collection_insert(
+      plugin_uris,
+      lilv_node_new_from_node(
+        world, sord_iter_get_node(plug_results, SORD_SUBJECT)));
+  }
+  sord_iter_free(plug_results);
 
   // Find any loaded plugins that will be replaced with a newer version
   LilvNodes* unload_uris = lilv_nodes_new();
-  FOREACH_MATCH (plug_results) {
-    const SordNode* plug = sord_iter_get_node(plug_results, SORD_SUBJECT);
+  LilvNodes* new_files   = lilv_nodes_new();
+  LILV_FOREACH (nodes, p, plugin_uris) {
+    const LilvNode* const plugin_uri = lilv_nodes_get(plugin_uris, p);
+    const SordNode* const plug       = plugin_uri->node;
 
-    LilvNode*         plugin_uri = lilv_node_new_from_node(world, plug);
-    const LilvPlugin* plugin =
-      lilv_plugins_get_by_uri(world->plugins, plugin_uri);
+    LilvPlugin* plugin =
+      (LilvPlugin*)lilv_plugins_get_by_uri(world->plugins, plugin_uri);
     const LilvNode* last_bundle =
       plugin ? lilv_plugin_get_bundle_uri(plugin) : NULL;
     if (!plugin || sord_node_equals(bundle_node, last_bundle->node)) {
-      // No previously loaded version, or it's from the same bundle
-      lilv_node_free(plugin_uri);
-      continue;
+      continue; // No previously loaded version, or it's from the same bundle
     }
 
     // Compare versions
-    SordModel*  this_model   = load_plugin_model(world, bundle_uri, plugin_uri);
-    LilvVersion this_version = get_version(world, this_model, plugin_uri);
-    SordModel*  last_model = load_plugin_model(world, last_bundle, plugin_uri);
-    LilvVersion last_version = get_version(world, last_model, plugin_uri);
-    sord_free(this_model);
-    sord_free(last_model);
+    const LilvVersion this_version =
+      lilv_world_get_plugin_version(world, bundle_node, plug, new_files);
+    const LilvVersion last_version =
+      lilv_world_get_loaded_version(world, plugin);
+
+    if (world->opt.stats) {
+      ++world->stats.n_version_conflicts;
+    }
+
     const int cmp = lilv_version_cmp(&this_version, &last_version);
     if (cmp > 0) {
-      zix_tree_insert(
-        (ZixTree*)unload_uris, lilv_node_duplicate(plugin_uri), NULL);
+      lilv_collection_insert(unload_uris, lilv_node_duplicate(plugin_uri));
       LILV_WARNF("Replacing version %d.%d of <%s> from <%s>\n",
                  last_version.minor,
                  last_version.micro,
@@ -803,17 +1508,19 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
       LILV_NOTEF("Newer version of <%s> loaded from <%s>\n",
                  sord_node_get_string(plug),
                  sord_node_get_string(last_bundle->node));
-      lilv_node_free(plugin_uri);
-      sord_iter_free(plug_results);
+      LILV_FOREACH (nodes, i, new_files) {
+        lilv_world_unload_file(world, lilv_nodes_get(new_files, i));
+      }
       lilv_world_drop_graph(world, bundle_node);
-      lilv_node_free(manifest);
+      lilv_nodes_free(new_files);
       lilv_nodes_free(unload_uris);
+      lilv_nodes_free(plugin_uris);
       return;
     }
-    lilv_node_free(plugin_uri);
   }
 
-  sord_iter_free(plug_results);
+  lilv_nodes_free(new_files);
+  lilv_nodes_free(plugin_uris);
 
   // Unload any old conflicting plugins
   LilvNodes* unload_bundles = lilv_nodes_new();
@@ -824,15 +1531,15 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 
     // Unload plugin and record bundle for later unloading
     lilv_world_unload_resource(world, uri);
-    zix_tree_insert(
-      (ZixTree*)unload_bundles, lilv_node_duplicate(bundle), NULL);
+    lilv_collection_insert(unload_bundles, lilv_node_duplicate(bundle));
   }
   lilv_nodes_free(unload_uris);
 
   // Now unload the associated bundles
   // This must be done last since several plugins could be in the same bundle
+  // The bundles are still recorded, so rescanning will not load them again
   LILV_FOREACH (nodes, i, unload_bundles) {
-    lilv_world_unload_bundle(world, lilv_nodes_get(unload_bundles, i));
+    lilv_world_drop_bundle(world, lilv_nodes_get(unload_bundles, i));
   }
   lilv_nodes_free(unload_bundles);
 
@@ -861,8 +1568,35 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
     }
     sord_iter_free(i);
   }
+}
 
+void
+lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+  if (!lilv_node_is_uri(bundle_uri)) {
+    LILV_ERRORF("Bundle URI `%s' is not a URI\n",
+                sord_node_get_string(bundle_uri->node));
+    return;
+  }
+
+  LILV_TRACE_BEGIN(world, lilv_node_as_string(bundle_uri));
+
+  lilv_world_record_bundle(world, bundle_uri);
+
+  LilvNode* manifest = lilv_world_get_manifest_uri(world, bundle_uri);
+
+  // Read manifest into model with graph = bundle_node
+  SerdStatus st = lilv_world_load_graph(world, bundle_uri->node, manifest);
+  if (st > SERD_FAILURE) {
+    LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
+    lilv_node_free(manifest);
+    LILV_TRACE_END();
+    return;
+  }
+
+  lilv_world_add_bundle(world, bundle_uri, manifest);
   lilv_node_free(manifest);
+  LILV_TRACE_END();
 }
 
 static int
@@ -888,13 +1622,64 @@ static int
 lilv_world_unload_file(LilvWorld* world, const LilvNode* file)
 {
   ZixTreeIter* iter = NULL;
-  if (!zix_tree_find((ZixTree*)world->loaded_files, file, &iter)) {
-    zix_tree_remove((ZixTree*)world->loaded_files, iter);
+  if (!zix_tree_find(world->loaded_files, file, &iter)) {
+    zix_tree_remove(world->loaded_files, iter);
     return 0;
   }
   return 1;
 }
 
+/** Unload a bundle, but keep its record so rescanning ignores it. */
+static int
+lilv_world_drop_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+  LilvBundle* const bundle =
+    (LilvBundle*)lilv_tree_get_by_uri(world->bundles, bundle_uri);
+
+  if (bundle) {
+    // Unload all loaded files in the bundle
+    LILV_FOREACH (nodes, i, bundle->files) {
+      lilv_world_unload_file(world, lilv_nodes_get(bundle->files, i));
+    }
+
+    lilv_nodes_free(bundle->files);
+    bundle->files = NULL;
+
+    /* Remove any plugins in the bundle from the plugin list.  Since the
+       application may still have a pointer to the LilvPlugin, it can not be
+       destroyed here.  Instead, we move it to the zombie plugin list, so it
+       will not be in the list returned by lilv_world_get_all_plugins() but
+       can still be used.
+    */
+    for (size_t p = 0U; p < bundle->n_plugins; ++p) {
+      LilvPlugin* const  plugin = bundle->plugins[p];
+      ZixTreeIter* const i =
+        lilv_tree_find_by_uri((ZixTree*)world->plugins, plugin->plugin_uri);
+
+      if (i && zix_tree_get(i) == plugin) {
+        lilv_plugins_remove(world->plugins, world->plugin_index, i);
+        lilv_plugins_insert(world->zombies, world->zombie_index, plugin);
+      }
+    }
+
+    bundle->n_plugins = 0U;
+  }
+
+  // Remove any specifications in the bundle, they are re-added on reload
+  for (LilvSpec** s = &world->specs; *s;) {
+    LilvSpec* const spec = *s;
+    if (sord_node_equals(spec->bundle, bundle_uri->node)) {
+      *s = spec->next;
+      lilv_spec_free(world, spec);
+    } else {
+      s = &spec->next;
+    }
+  }
+
+  // Drop everything in bundle graph
+  return lilv_world_drop_graph(world, bundle_uri->node);
+}
+
 int
 lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 {
@@ -902,69 +1687,75 @@ lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
     return 0;
   }
 
-  // Find all loaded files that are inside the bundle
-  LilvNodes* files = lilv_nodes_new();
-  LILV_FOREACH (nodes, i, world->loaded_files) {
-    const LilvNode* file = lilv_nodes_get(world->loaded_files, i);
-    if (!strncmp(lilv_node_as_string(file),
-                 lilv_node_as_string(bundle_uri),
-                 strlen(lilv_node_as_string(bundle_uri)))) {
-      zix_tree_insert((ZixTree*)files, lilv_node_duplicate(file), NULL);
-    }
-  }
+  const int st = lilv_world_drop_bundle(world, bundle_uri);
 
-  // Unload all loaded files in the bundle
-  LILV_FOREACH (nodes, i, files) {
-    const LilvNode* file = lilv_nodes_get(world->plugins, i);
-    lilv_world_unload_file(world, file);
+  // Forget the bundle so it will be loaded again if rescanning finds it
+  ZixTreeIter* const i =
+    lilv_tree_find_by_uri(world->bundles, bundle_uri);
+  if (i) {
+    zix_tree_remove(world->bundles, i);
   }
 
-  lilv_nodes_free(files);
+  return st;
+}
 
-  /* Remove any plugins in the bundle from the plugin list.  Since the
-     application may still have a pointer to the LilvPlugin, it can not be
-     destroyed here.  Instead, we move it to the zombie plugin list, so it
-     will not be in the list returned by lilv_world_get_all_plugins() but can
-     still be used.
-  */
-  ZixTreeIter* i = zix_tree_begin((ZixTree*)world->plugins);
-  while (i != zix_tree_end((ZixTree*)world->plugins)) {
-    LilvPlugin*  p    = (LilvPlugin*)zix_tree_get(i);
-    ZixTreeIter* next = zix_tree_iter_next(i);
-
-    if (lilv_node_equals(lilv_plugin_get_bundle_uri(p), bundle_uri)) {
-      zix_tree_remove((ZixTree*)world->plugins, i);
-      zix_tree_insert((ZixTree*)world->zombies, p, NULL);
-    }
+/** Bundles found in LV2_PATH, in the order they were found. */
+typedef struct {
+  LilvWorld* world;
+  LilvNode** uris;
+  size_t     n_uris;
+} LilvBundleList;
+
+static void
+lilv_bundle_list_append(LilvBundleList* list, LilvNode* uri)
+{
+  list->uris =
+    (LilvNode**)realloc(list->uris, ++list->n_uris * sizeof(LilvNode*));
+  list->uris[list->n_uris - 1] = uri;
+}
 
-    i = next;
+static void
+lilv_bundle_list_clear(LilvBundleList* list)
+{
+  for (size_t i = 0; i < list->n_uris; ++i) {
+    lilv_node_free(list->uris[i]);
   }
 
-  // Drop everything in bundle graph
-  return lilv_world_drop_graph(world, bundle_uri->node);
+  free(list->uris);
+  list->uris   = NULL;
+  list->n_uris = 0;
 }
 
 static void
-load_dir_entry(const char* dir, const char* name, void* data)
+add_dir_entry(const char* dir, const char* name, void* data)
 {
-  LilvWorld* world = (LilvWorld*)data;
-  char*      path  = lilv_strjoin(dir, "/", name, "/", NULL);
-  SerdNode   suri  = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
-  LilvNode*  node  = lilv_new_uri(world, (const char*)suri.buf);
+  LilvBundleList* list = (LilvBundleList*)data;
+  char*           path = lilv_strjoin(dir, "/", name, "/", NULL);
+  SerdNode suri = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
+
+  lilv_bundle_list_append(list,
+                          lilv_new_uri(list->world, (const char*)suri.buf));
 
-  lilv_world_load_bundle(world, node);
-  lilv_node_free(node);
   serd_node_free(&suri);
   free(path);
 }
 
-/** Load all bundles in the directory at `dir_path`. */
+/** Find all bundles in the directory at `dir_path`. */
+static void
+find_bundles_in_directory(const char* dir_path, void* data)
+{
+  lilv_dir_for_each(dir_path, data, add_dir_entry);
+}
+
+/** Call `func` with the expanded path of `dir`. */
 static void
-lilv_world_load_directory(LilvWorld* world, const char* dir_path)
+lilv_visit_lv2_dir(const char* dir,
+                   void*       data,
+                   void (*func)(const char* dir, void* data))
 {
-  char* path = lilv_expand(dir_path);
+  char* const path = lilv_expand(dir);
   if (path) {
-    lilv_dir_for_each(path, world, load_dir_entry);
+    func(path, data);
     free(path);
   }
 }
@@ -980,13 +1771,15 @@ first_path_sep(const char* path)
   return NULL;
 }
 
-/** Load all bundles found in `lv2_path`.
+/** Call `func` for every directory in `lv2_path`.
  * @param lv2_path A colon-delimited list of directories.  These directories
  * should contain LV2 bundle directories (ie the search path is a list of
  * parent directories of bundles, not a list of bundle directories).
  */
-static void
-lilv_world_load_path(LilvWorld* world, const char* lv2_path)
+void
+lilv_lv2_path_for_each(const char* lv2_path,
+                       void*       data,
+                       void (*func)(const char* dir, void* data))
 {
   while (lv2_path[0] != '\0') {
     const char* const sep = first_path_sep(lv2_path);
@@ -995,19 +1788,76 @@ lilv_world_load_path(LilvWorld* world, const char* lv2_path)
       char* const  dir     = (char*)malloc(dir_len + 1);
       memcpy(dir, lv2_path, dir_len);
       dir[dir_len] = '\0';
-      lilv_world_load_directory(world, dir);
+      lilv_visit_lv2_dir(dir, data, func);
       free(dir);
       lv2_path += dir_len + 1;
     } else {
-      lilv_world_load_directory(world, lv2_path);
+      lilv_visit_lv2_dir(lv2_path, data, func);
       lv2_path = "\0";
     }
   }
 }
 
+/**
+   Load bundles in order, parsing manifests in parallel if enabled.
+
+   Manifests are parsed into separate models by worker threads, then merged
+   into the world model and added one at a time in the original order, so the
+   result is exactly the same as loading each bundle with
+   lilv_world_load_bundle().
+*/
+static void
+lilv_world_load_bundles(LilvWorld* world, LilvNode** uris, size_t n_uris)
+{
+  if (world->opt.discovery_threads <= 1 || n_uris < 2) {
+    for (size_t i = 0; i < n_uris; ++i) {
+      lilv_world_load_bundle(world, uris[i]);
+    }
+    return;
+  }
+
+  LilvParseBatch batch = {(LilvParseJob*)calloc(n_uris, sizeof(LilvParseJob)),
+                          n_uris,
+                          world->opt.cache_dir,
+                          NULL,
+                          0,
+                          world->opt.stats};
+
+  for (size_t i = 0; i < n_uris; ++i) {
+    lilv_world_record_bundle(world, uris[i]);
+    batch.jobs[i].uri   = lilv_world_get_manifest_uri(world, uris[i]);
+    batch.jobs[i].graph = uris[i]->node;
+  }
+
+  lilv_world_parse_files(world, &batch, world->opt.discovery_threads);
+
+  for (size_t i = 0; i < n_uris; ++i) {
+    LilvParseJob* const job = &batch.jobs[i];
+
+    LILV_TRACE_BEGIN(world, lilv_node_as_string(uris[i]));
+
+    const SerdStatus st = lilv_world_merge_file(world, job);
+    if (st > SERD_FAILURE) {
+      LILV_ERRORF("Error reading %s\n", lilv_node_as_string(job->uri));
+    } else {
+      lilv_world_add_bundle(world, uris[i], job->uri);
+    }
+
+    sord_free(job->model);
+    job->model = NULL;
+    lilv_node_free(job->uri);
+
+    LILV_TRACE_END();
+  }
+
+  lilv_parse_batch_clear(&batch);
+  free(batch.jobs);
+}
+
 void
 lilv_world_load_specifications(LilvWorld* world)
 {
+  world->specs_pending = false;
   for (LilvSpec* spec = world->specs; spec; spec = spec->next) {
     LILV_FOREACH (nodes, f, spec->data_uris) {
       LilvNode* file = (LilvNode*)lilv_collection_get(spec->data_uris, f);
@@ -1025,11 +1875,24 @@ lilv_world_load_plugin_classes(LilvWorld* world)
      is e.g. how a host would build a menu), they won't be seen anyway...
   */
 
+  world->classes_pending = false;
+
   SordIter* classes = sord_search(
     world->model, NULL, world->uris.rdf_a, world->uris.rdfs_Class, NULL);
   FOREACH_MATCH (classes) {
     const SordNode* class_node = sord_iter_get_node(classes, SORD_SUBJECT);
 
+    // Skip classes that are already loaded, to avoid allocating them again
+    LilvNode* const              class_uri =
+      lilv_node_new_from_node(world, class_node);
+    const LilvPluginClass* const existing =
+      lilv_plugin_classes_get_by_uri(world->plugin_classes, class_uri);
+
+    lilv_node_free(class_uri);
+    if (existing) {
+      continue;
+    }
+
     SordNode* parent = sord_get(
       world->model, class_node, world->uris.rdfs_subClassOf, NULL, NULL);
     if (!parent || sord_node_get_type(parent) != SORD_URI) {
@@ -1045,18 +1908,62 @@ lilv_world_load_plugin_classes(LilvWorld* world)
 
     LilvPluginClass* pclass = lilv_plugin_class_new(
       world, parent, class_node, (const char*)sord_node_get_string(label));
-    if (pclass) {
-      zix_tree_insert((ZixTree*)world->plugin_classes, pclass, NULL);
+    if (pclass && !lilv_collection_insert(world->plugin_classes, pclass)) {
+      zix_hash_insert(world->class_index, &pclass, NULL);
     }
 
     sord_node_free(world->world, label);
     sord_node_free(world->world, parent);
   }
   sord_iter_free(classes);
+
+  lilv_plugin_class_index_children(world);
 }
 
 void
-lilv_world_load_all(LilvWorld* world)
+lilv_world_ensure_specifications(LilvWorld* world)
+{
+  if (world->specs_pending) {
+    lilv_world_load_specifications(world);
+  }
+}
+
+void
+lilv_world_ensure_plugin_classes(LilvWorld* world)
+{
+  if (world->classes_pending) {
+    lilv_world_ensure_specifications(world);
+    lilv_world_load_plugin_classes(world);
+  }
+}
+
+/** Return the flag for `uri` if it is in `uris` (by flag bit), or zero. */
+static uint32_t
+lilv_uri_flag(SordNode* const* uris, unsigned n_uris, const SordNode* uri)
+{
+  for (unsigned i = 0U; i < n_uris; ++i) {
+    if (uris[i] == uri) { // Sord nodes are interned
+      return 1U << i;
+    }
+  }
+
+  return 0U;
+}
+
+uint32_t
+lilv_world_port_class_flag(const LilvWorld* world, const SordNode* uri)
+{
+  return lilv_uri_flag(world->port_classes, LILV_N_PORT_CLASSES, uri);
+}
+
+uint32_t
+lilv_world_port_property_flag(const LilvWorld* world, const SordNode* uri)
+{
+  return lilv_uri_flag(world->port_properties, LILV_N_PORT_PROPERTIES, uri);
+}
+
+const char*
+lilv_world_lv2_path(const LilvWorld* world)
 {
   const char* lv2_path = world->opt.lv2_path;
   if (!lv2_path) {
@@ -1066,58 +1973,301 @@ lilv_world_load_all(LilvWorld* world)
     lv2_path = LILV_DEFAULT_LV2_PATH;
   }
 
-  // Discover bundles and read all manifest files into model
-  lilv_world_load_path(world, lv2_path);
+  return lv2_path;
+}
+
+/** Return the plugin in the world with the given URI node, or NULL. */
+static LilvPlugin*
+lilv_world_find_plugin(LilvWorld* world, const SordNode* uri)
+{
+  if (sord_node_get_type(uri) != SORD_URI) {
+    return NULL;
+  }
+
+  LilvNode* const   node   = lilv_node_new_from_node(world, uri);
+  LilvPlugin* const plugin =
+    (LilvPlugin*)lilv_index_find(world->plugin_index, node);
+
+  lilv_node_free(node);
+  return plugin;
+}
+
+void
+lilv_world_index_replacements(LilvWorld* world, const SordNode* subject)
+{
+  // ?new dc:replaces ?old
+  SordIter* const r = sord_search(
+    world->model, subject, world->uris.dc_replaces, NULL, NULL);
+  FOREACH_MATCH (r) {
+    const SordNode* const new_node = sord_iter_get_node(r, SORD_SUBJECT);
+    const SordNode* const old_node = sord_iter_get_node(r, SORD_OBJECT);
+    if (sord_node_get_type(old_node) != SORD_URI) {
+      continue;
+    }
 
+    LilvPlugin* const old_plugin = lilv_world_find_plugin(world, old_node);
+    if (old_plugin) {
+      old_plugin->replaced = true;
+    }
+
+    LilvPlugin* const new_plugin = lilv_world_find_plugin(world, new_node);
+    if (new_plugin && new_plugin != old_plugin) {
+      // Use the first replacement if there are several
+      LilvReplacement entry = {sord_node_copy(old_node), new_plugin};
+      if (zix_hash_insert(world->replacements, &entry, NULL)) {
+        sord_node_free(world->world, entry.uri);
+      }
+    }
+  }
+  sord_iter_free(r);
+}
+
+/**
+   Set the replaced flag of every plugin with a dc:replaces statement.
+
+   This also rebuilds the index of replacements, which maps the URI of every
+   replaced plugin (loaded or not) to the loaded plugin that replaces it.
+*/
+static void
+lilv_world_update_replaced(LilvWorld* world)
+{
   LILV_FOREACH (plugins, p, world->plugins) {
-    const LilvPlugin* plugin =
-      (const LilvPlugin*)lilv_collection_get((ZixTree*)world->plugins, p);
-
-    // ?new dc:replaces plugin
-    if (sord_ask(world->model,
-                 NULL,
-                 world->uris.dc_replaces,
-                 lilv_plugin_get_uri(plugin)->node,
-                 NULL)) {
-      // TODO: Check if replacement is a known plugin? (expensive)
-      ((LilvPlugin*)plugin)->replaced = true;
+    ((LilvPlugin*)lilv_plugins_get(world->plugins, p))->replaced = false;
+  }
+
+  lilv_replacement_index_free(world, world->replacements);
+  world->replacements = lilv_replacement_index_new();
+
+  lilv_world_index_replacements(world, NULL);
+}
+
+const LilvPlugin*
+lilv_world_get_replacement(const LilvWorld* world, const LilvNode* plugin_uri)
+{
+  if (!lilv_node_is_uri(plugin_uri)) {
+    return NULL;
+  }
+
+  const LilvReplacement        key = {plugin_uri->node, NULL};
+  const LilvReplacement* const entry =
+    (const LilvReplacement*)zix_hash_find(world->replacements, &key);
+
+  if (!entry) {
+    return NULL;
+  }
+
+  // Check that the replacement has not been unloaded since it was indexed
+  const struct LilvHeader* const loaded =
+    lilv_index_find(world->plugin_index, entry->plugin->plugin_uri);
+
+  return loaded == (const struct LilvHeader*)entry->plugin ? entry->plugin
+                                                            : NULL;
+}
+
+void
+lilv_world_load_all(LilvWorld* world)
+{
+  // Discover bundles and read all manifest files into model
+  LilvBundleList bundles = {world, NULL, 0};
+  lilv_lv2_path_for_each(
+    lilv_world_lv2_path(world), &bundles, find_bundles_in_directory);
+  lilv_world_load_bundles(world, bundles.uris, bundles.n_uris);
+  lilv_bundle_list_clear(&bundles);
+
+  lilv_world_update_replaced(world);
+
+  // Load specifications and plugin classes when they are first needed
+  world->specs_pending   = true;
+  world->classes_pending = true;
+}
+
+void
+lilv_world_load_all_plugin_data(LilvWorld* world)
+{
+  // Make a job for every data file of an unloaded plugin, once per file
+  LilvParseBatch batch = {
+    NULL, 0, world->opt.cache_dir, NULL, 0, world->opt.stats};
+  LilvNodes*     files = lilv_nodes_new();
+  LILV_FOREACH (plugins, i, world->plugins) {
+    const LilvPlugin* const plugin = lilv_plugins_get(world->plugins, i);
+    if (plugin->loaded) {
+      continue;
     }
+
+    LILV_FOREACH (nodes, f, plugin->data_uris) {
+      const LilvNode* const file = lilv_nodes_get(plugin->data_uris, f);
+
+      ZixTreeIter* iter = NULL;
+      if (lilv_nodes_contains(files, file) ||
+          !zix_tree_find(world->loaded_files, file, &iter)) {
+        continue; // Already loaded or in the batch
+      }
+
+      lilv_collection_insert(files, lilv_node_duplicate(file));
+
+      batch.jobs = (LilvParseJob*)realloc(
+        batch.jobs, ++batch.n_jobs * sizeof(LilvParseJob));
+
+      LilvParseJob* const job = &batch.jobs[batch.n_jobs - 1];
+      memset(job, 0, sizeof(LilvParseJob));
+      job->uri   = lilv_node_duplicate(file);
+      job->graph = plugin->bundle_uri->node;
+    }
+  }
+
+  // Parse everything, then merge into the world model in order
+  lilv_world_parse_files(world, &batch, world->opt.discovery_threads);
+  for (size_t i = 0; i < batch.n_jobs; ++i) {
+    LilvParseJob* const job = &batch.jobs[i];
+
+    if (lilv_world_merge_file(world, job) > SERD_FAILURE) {
+      LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(job->uri));
+    }
+
+    sord_free(job->model);
+    job->model = NULL;
+    lilv_node_free(job->uri);
   }
 
-  // Query out things to cache
-  lilv_world_load_specifications(world);
-  lilv_world_load_plugin_classes(world);
+  lilv_parse_batch_clear(&batch);
+  free(batch.jobs);
+  lilv_nodes_free(files);
+
+  // Finish loading plugins, which only parses files that failed above
+  LILV_FOREACH (plugins, i, world->plugins) {
+    lilv_plugin_load_if_necessary(lilv_plugins_get(world->plugins, i));
+  }
 }
 
-SerdStatus
-lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri)
+unsigned
+lilv_world_trim_libraries(LilvWorld* world)
 {
-  ZixTreeIter* iter = NULL;
-  if (!zix_tree_find((ZixTree*)world->loaded_files, uri, &iter)) {
-    return SERD_FAILURE; // File has already been loaded
+  const unsigned n_released = lilv_lib_release_preloaded(world);
+
+  return n_released + lilv_lib_trim(world, 0U);
+}
+
+void
+lilv_world_freeze(LilvWorld* world)
+{
+  lilv_world_ensure_plugin_classes(world);
+
+  // Fill every lazily loaded plugin field so queries only read the plugin
+  LILV_FOREACH (plugins, i, world->plugins) {
+    const LilvPlugin* const plugin = lilv_plugins_get(world->plugins, i);
+
+    lilv_plugin_get_port_table(plugin);
+    lilv_plugin_get_class(plugin);
+    lilv_plugin_get_library_uri(plugin);
   }
 
-  size_t               uri_len = 0;
-  const uint8_t* const uri_str =
-    sord_node_get_string_counted(uri->node, &uri_len);
-  if (strncmp((const char*)uri_str, "file:", 5)) {
-    return SERD_FAILURE; // Not a local file
+  world->frozen = true;
+}
+
+int
+lilv_world_refresh_bundles(LilvWorld*       world,
+                           LilvNode* const* uris,
+                           size_t           n_uris,
+                           bool             force)
+{
+  ZixTree* const bundles   = world->bundles;
+  LilvBundleList inactive  = {world, NULL, 0};
+  LilvBundleList load      = {world, NULL, 0};
+  int            n_changed = 0;
+
+  for (size_t i = 0; i < n_uris; ++i) {
+    const LilvNode* const   uri = uris[i];
+    const LilvBundle* const bundle =
+      (const LilvBundle*)lilv_tree_get_by_uri(bundles, uri);
+
+    if (bundle && !force && lilv_bundle_stamp(uri) == bundle->stamp) {
+      continue; // Unchanged
+    }
+
+    char* const path   = lilv_file_uri_parse(lilv_node_as_uri(uri), NULL);
+    const bool  exists = path && lilv_is_directory(path);
+    lilv_free(path);
+
+    if (bundle) {
+      lilv_world_unload_bundle(world, uri);
+    }
+
+    if (exists) {
+      lilv_bundle_list_append(&load, lilv_node_duplicate(uri));
+    }
+
+    n_changed += (bundle || exists);
   }
 
-  if (strcmp((const char*)uri_str + uri_len - 4, ".ttl")) {
-    return SERD_FAILURE; // Not a Turtle file
+  /* Unloading a bundle may have removed a newer version of a plugin, so give
+     any bundles with nothing loaded (like older versions that were ignored)
+     another chance. */
+  if (n_changed) {
+    for (ZixTreeIter* i = zix_tree_begin(bundles); !zix_tree_iter_is_end(i);
+         i = zix_tree_iter_next(i)) {
+      const LilvBundle* const bundle = (const LilvBundle*)zix_tree_get(i);
+      if (!sord_ask(world->model, NULL, NULL, NULL, bundle->uri->node)) {
+        lilv_bundle_list_append(&inactive, lilv_node_duplicate(bundle->uri));
+      }
+    }
+
+    for (size_t i = 0; i < inactive.n_uris; ++i) {
+      lilv_world_unload_bundle(world, inactive.uris[i]);
+      lilv_bundle_list_append(&load, lilv_node_duplicate(inactive.uris[i]));
+    }
   }
 
-  serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
-  const SerdStatus st = serd_reader_read_file(reader, uri_str);
-  if (st) {
-    LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(uri));
-    return st;
+  lilv_world_load_bundles(world, load.uris, load.n_uris);
+
+  if (n_changed) {
+    lilv_world_update_replaced(world);
+    world->specs_pending   = true;
+    world->classes_pending = true;
   }
 
-  zix_tree_insert(
-    (ZixTree*)world->loaded_files, lilv_node_duplicate(uri), NULL);
-  return SERD_SUCCESS;
+  lilv_bundle_list_clear(&load);
+  lilv_bundle_list_clear(&inactive);
+
+  return n_changed;
+}
+
+int
+lilv_world_rescan(LilvWorld* world)
+{
+  LilvBundleList found = {world, NULL, 0};
+  lilv_lv2_path_for_each(
+    lilv_world_lv2_path(world), &found, find_bundles_in_directory);
+
+  for (ZixTreeIter* i = zix_tree_begin(world->bundles);
+       !zix_tree_iter_is_end(i);
+       i = zix_tree_iter_next(i)) {
+    ((LilvBundle*)zix_tree_get(i))->seen = false;
+  }
+
+  for (size_t i = 0; i < found.n_uris; ++i) {
+    LilvBundle* const bundle =
+      (LilvBundle*)lilv_tree_get_by_uri(world->bundles, found.uris[i]);
+    if (bundle) {
+      bundle->seen = true;
+    }
+  }
+
+  /* Also check bundles that were not found in LV2_PATH, which have either
+     been removed, or were explicitly loaded from elsewhere. */
+  for (ZixTreeIter* i = zix_tree_begin(world->bundles);
+       !zix_tree_iter_is_end(i);
+       i = zix_tree_iter_next(i)) {
+    const LilvBundle* const bundle = (const LilvBundle*)zix_tree_get(i);
+    if (!bundle->seen) {
+      lilv_bundle_list_append(&found, lilv_node_duplicate(bundle->uri));
+    }
+  }
+
+  const int n_changed =
+    lilv_world_refresh_bundles(world, found.uris, found.n_uris, false);
+
+  lilv_bundle_list_clear(&found);
+  return n_changed;
 }
 
 int
@@ -1192,6 +2342,8 @@ lilv_world_get_plugin_class(const LilvWorld* world)
 const LilvPluginClasses*
 lilv_world_get_plugin_classes(const LilvWorld* world)
 {
+  lilv_world_ensure_plugin_classes((LilvWorld*)world);
+
   return world->plugin_classes;
 }
 
@@ -1205,13 +2357,11 @@ LilvNode*
 lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject)
 {
   // Check for explicitly given symbol
-  SordNode* snode =
-    sord_get(world->model, subject->node, world->uris.lv2_symbol, NULL, NULL);
+  LilvNode* const symbol =
+    lilv_world_get_node(world, subject->node, world->uris.lv2_symbol, NULL);
 
-  if (snode) {
-    LilvNode* ret = lilv_node_new_from_node(world, snode);
-    sord_node_free(world->world, snode);
-    return ret;
+  if (symbol) {
+    return symbol;
   }
 
   if (!lilv_node_is_uri(subject)) {
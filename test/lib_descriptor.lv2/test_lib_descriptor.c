@@ -42,6 +42,55 @@ main(int argc, char** argv)
   assert(instance);
   lilv_instance_free(instance);
 
+  // Create instances ahead of time in a pool, and reuse them
+  LilvInstancePool* pool = lilv_instance_pool_new(plugin, 48000.0, NULL, 2);
+  assert(lilv_instance_pool_wait(pool) == 2);
+
+  LilvInstance* first  = lilv_instance_pool_acquire(pool);
+  LilvInstance* second = lilv_instance_pool_acquire(pool);
+  assert(first && second && first != second);
+  assert(!lilv_instance_pool_acquire(pool));
+
+  lilv_instance_pool_release(pool, first);
+  assert(lilv_instance_pool_acquire(pool) == first);
+  lilv_instance_pool_release(pool, first);
+  lilv_instance_pool_release(pool, second);
+  lilv_instance_pool_free(pool);
+
+  // Instantiate several plugins at once
+  LilvInstantiateRequest requests[] = {
+    {plugin, 48000.0, NULL, NULL, LILV_INSTANTIATE_FAILED},
+    {plugin, 44100.0, NULL, NULL, LILV_INSTANTIATE_FAILED},
+  };
+
+  assert(lilv_world_instantiate(world, requests, 2, 2) == 2);
+  for (unsigned i = 0U; i < 2U; ++i) {
+    assert(requests[i].status == LILV_INSTANTIATE_SUCCESS);
+    assert(requests[i].instance);
+    lilv_instance_free(requests[i].instance);
+  }
+
+  // Keep the library open after the last instance is freed
+  LilvNode* keep = lilv_new_int(world, 1);
+  lilv_world_set_option(world, LILV_OPTION_KEEP_LIBRARIES, keep);
+  lilv_node_free(keep);
+
+  lilv_instance_free(lilv_plugin_instantiate(plugin, 48000.0, NULL));
+  instance = lilv_plugin_instantiate(plugin, 48000.0, NULL);
+  assert(instance);
+  assert(lilv_world_trim_libraries(world) == 0); // Library is in use
+  lilv_instance_free(instance);
+  assert(lilv_world_trim_libraries(world) == 1);
+  assert(lilv_world_trim_libraries(world) == 0);
+
+  // Preload the library, which stays open until it is trimmed
+  const LilvPlugin* const preload[] = {plugin, plugin};
+  assert(lilv_world_preload_libraries(world, preload, 2, NULL, 2) == 1);
+  assert(lilv_world_preload_libraries(world, preload, 1, NULL, 1) == 0);
+  lilv_instance_free(lilv_plugin_instantiate(plugin, 48000.0, NULL));
+  assert(lilv_world_trim_libraries(world) == 1);
+  assert(lilv_world_trim_libraries(world) == 0);
+
   LilvNode* eg_blob = lilv_new_uri(world, "http://example.org/blob");
   LilvNode* blob    = lilv_world_get(world, plugin_uri, eg_blob, NULL);
   assert(lilv_node_is_literal(blob));
@@ -0,0 +1,195 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+#include "../src/lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	doap:name \"Test plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+		lv2:default 0.5 ;\n\
+	] .\n";
+
+static unsigned n_cache_files = 0U;
+
+static void
+count_file(const char* path, const char* name, void* data)
+{
+  (void)path;
+  (void)data;
+
+  const size_t len = strlen(name);
+  if (len > 6 && !strcmp(name + len - 6, ".cache")) {
+    ++n_cache_files;
+  }
+}
+
+static void
+remove_file(const char* path, const char* name, void* data)
+{
+  (void)data;
+
+  char* const file_path = lilv_path_join(path, name);
+  lilv_remove(file_path);
+  free(file_path);
+}
+
+/** Offset of the source path length in a cache file, after the header. */
+#define PATH_LEN_OFFSET 32L
+
+/** Overwrite the length of a string in a cache file with a bogus value. */
+static void
+corrupt_file(const char* path, const char* name, void* data)
+{
+  const bool* const in_node   = (const bool*)data;
+  char* const       file_path = lilv_path_join(path, name);
+  FILE* const       file      = fopen(file_path, "r+b");
+  assert(file);
+
+  long offset = PATH_LEN_OFFSET;
+  if (*in_node) {
+    // Skip the path and node count, then the type and datatype of a node
+    uint32_t path_len = 0U;
+    fseek(file, offset, SEEK_SET);
+    const size_t n_read = fread(&path_len, sizeof(path_len), 1, file);
+    assert(n_read == 1);
+    offset += 4L + (long)path_len + 1L + 4L + 4L + 4L;
+  }
+
+  const uint32_t bogus_len = 0xFFFFFFFFU;
+  fseek(file, offset, SEEK_SET);
+  const size_t n_written = fwrite(&bogus_len, sizeof(bogus_len), 1, file);
+  assert(n_written == 1);
+
+  fclose(file);
+  free(file_path);
+}
+
+static void
+check_plugin(LilvWorld*      world,
+             const LilvNode* bundle,
+             const char*     cache_dir,
+             const uint64_t  n_cached)
+{
+  LilvNode* dir = lilv_new_string(world, cache_dir);
+  lilv_world_set_option(world, LILV_OPTION_CACHE_DIR, dir);
+  lilv_node_free(dir);
+
+  LilvNode* stats = lilv_new_bool(world, true);
+  lilv_world_set_option(world, LILV_OPTION_STATS, stats);
+  lilv_node_free(stats);
+
+  lilv_world_load_bundle(world, bundle);
+
+  LilvNode* const uri = lilv_new_uri(world, "http://example.org/plug");
+
+  const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+  const LilvPlugin*  plug    = lilv_plugins_get_by_uri(plugins, uri);
+  assert(plug);
+
+  LilvNode* const name = lilv_plugin_get_name(plug);
+  assert(!strcmp(lilv_node_as_string(name), "Test plugin"));
+  assert(lilv_plugin_get_num_ports(plug) == 1);
+
+  // Port is a blank node, so this checks that blank node labels work
+  const LilvPort* const port = lilv_plugin_get_port_by_index(plug, 0);
+  LilvNode*             def  = NULL;
+  lilv_port_get_range(plug, port, &def, NULL, NULL);
+  assert(def);
+  assert(lilv_node_as_float(def) == 0.5f);
+
+  // Check that both data files were counted as either parsed or cached
+  const LilvWorldStats world_stats = lilv_world_get_stats(world);
+  assert(world_stats.n_files_cached == n_cached);
+  assert(world_stats.n_files_parsed == 2U - n_cached);
+
+  lilv_node_free(def);
+  lilv_node_free(name);
+  lilv_node_free(uri);
+}
+
+int
+main(void)
+{
+  LilvTestEnv* const env = lilv_test_env_new();
+  if (create_bundle(env, "cache.lv2", SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+    return 1;
+  }
+
+  char* const cache_dir = lilv_create_temporary_directory("lilvXXXXXX");
+
+  // Load bundle, which writes data files to the cache
+  check_plugin(env->world, env->test_bundle_uri, cache_dir, 0U);
+  lilv_dir_for_each(cache_dir, NULL, count_file);
+  assert(n_cache_files == 2U);
+
+  // Load bundle in a new world, which reads data files from the cache
+  LilvWorld* const world  = lilv_world_new();
+  LilvNode* const  bundle =
+    lilv_new_uri(world, lilv_node_as_uri(env->test_bundle_uri));
+
+  check_plugin(world, bundle, cache_dir, 2U);
+
+  n_cache_files = 0U;
+  lilv_dir_for_each(cache_dir, NULL, count_file);
+  assert(n_cache_files == 2U);
+
+  lilv_node_free(bundle);
+  lilv_world_free(world);
+
+  // Corrupt string lengths in the header and node table, which are ignored
+  for (unsigned i = 0U; i < 2U; ++i) {
+    bool in_node = i;
+    lilv_dir_for_each(cache_dir, &in_node, corrupt_file);
+
+    LilvWorld* const corrupt_world = lilv_world_new();
+    LilvNode* const  corrupt_bundle =
+      lilv_new_uri(corrupt_world, lilv_node_as_uri(env->test_bundle_uri));
+
+    check_plugin(corrupt_world, corrupt_bundle, cache_dir, 0U);
+
+    lilv_node_free(corrupt_bundle);
+    lilv_world_free(corrupt_world);
+  }
+
+  lilv_dir_for_each(cache_dir, NULL, remove_file);
+  lilv_remove(cache_dir);
+  free(cache_dir);
+
+  delete_bundle(env);
+  lilv_test_env_free(env);
+
+  return 0;
+}
@@ -68,6 +68,60 @@ main(void)
       lilv_plugin_class_get_uri(plugin)));
   }
 
+  // Plugins in a class subtree include those in descendant classes
+  LilvNode* const plug_uri = lilv_new_uri(world, "http://example.org/plug");
+  const LilvPlugin* const plug =
+    lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world), plug_uri);
+  assert(plug);
+
+  LilvPlugins* all_plugins = lilv_plugin_class_get_plugins(plugin);
+  assert(lilv_plugins_size(all_plugins) ==
+         lilv_plugins_size(lilv_world_get_all_plugins(world)));
+  assert(lilv_plugins_get_by_uri(all_plugins, plug_uri) == plug);
+  lilv_plugins_free(all_plugins);
+
+  // The class is only in the plugin data, which has not been loaded yet
+  LilvNode* const compressor_uri =
+    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#CompressorPlugin");
+  LilvNode* const dynamics_uri =
+    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#DynamicsPlugin");
+  const LilvPluginClass* const compressor =
+    lilv_plugin_classes_get_by_uri(classes, compressor_uri);
+  const LilvPluginClass* const dynamics =
+    lilv_plugin_classes_get_by_uri(classes, dynamics_uri);
+  assert(compressor);
+  assert(dynamics);
+
+  LilvPlugins* class_plugins = lilv_plugin_class_get_plugins(compressor);
+  assert(lilv_plugins_size(class_plugins) == 1);
+  assert(lilv_plugins_get_by_uri(class_plugins, plug_uri) == plug);
+  lilv_plugins_free(class_plugins);
+
+  LilvPlugins* parent_plugins = lilv_plugin_class_get_plugins(dynamics);
+  assert(lilv_plugins_get_by_uri(parent_plugins, plug_uri) == plug);
+  lilv_plugins_free(parent_plugins);
+
+  assert(lilv_node_equals(
+    lilv_plugin_class_get_uri(lilv_plugin_get_class(plug)), compressor_uri));
+
+  lilv_node_free(dynamics_uri);
+  lilv_node_free(compressor_uri);
+
+  // Unrelated classes have no plugins
+  LilvNode* const reverb_uri =
+    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#ReverbPlugin");
+  const LilvPluginClass* const reverb =
+    lilv_plugin_classes_get_by_uri(classes, reverb_uri);
+
+  if (reverb) {
+    LilvPlugins* reverb_plugins = lilv_plugin_class_get_plugins(reverb);
+    assert(!lilv_plugins_get_by_uri(reverb_plugins, plug_uri));
+    lilv_plugins_free(reverb_plugins);
+  }
+
+  lilv_node_free(reverb_uri);
+  lilv_node_free(plug_uri);
+
   LilvNode* some_uri = lilv_new_uri(world, "http://example.org/whatever");
   assert(lilv_plugin_classes_get_by_uri(classes, some_uri) == NULL);
   lilv_node_free(some_uri);
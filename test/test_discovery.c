@@ -21,6 +21,8 @@
 #include "lilv/lilv.h"
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 
 static const char* const plugin_ttl = "\
@@ -59,6 +61,10 @@ main(void)
   LilvTestEnv* const env   = lilv_test_env_new();
   LilvWorld* const   world = env->world;
 
+  LilvNode* const stats = lilv_new_bool(world, true);
+  lilv_world_set_option(world, LILV_OPTION_STATS, stats);
+  lilv_node_free(stats);
+
   if (create_bundle(env, "discovery.lv2", SIMPLE_MANIFEST_TTL, plugin_ttl)) {
     return 1;
   }
@@ -90,6 +96,22 @@ main(void)
   assert(discovery_plugin_found);
   plugins = NULL;
 
+  // Check the work counted while loading and querying
+  const LilvWorldStats counts = lilv_world_get_stats(world);
+  assert(counts.n_files_parsed >= 2);
+  assert(counts.n_files_cached == 0);
+  assert(counts.n_bytes_read > 0);
+  assert(counts.n_triples > 0);
+  assert(counts.n_bundles_loaded == 1);
+  assert(counts.n_version_conflicts == 0);
+  assert(counts.n_plugin_loads == 1);
+  assert(counts.n_queries > 0);
+
+  FILE* const stream = tmpfile();
+  lilv_world_print_stats(world, stream);
+  assert(ftell(stream) > 0);
+  fclose(stream);
+
   delete_bundle(env);
   lilv_test_env_free(env);
 
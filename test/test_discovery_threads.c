@@ -0,0 +1,120 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+static LilvWorld*
+load_world(const unsigned n_threads)
+{
+  LilvWorld* const world   = lilv_world_new();
+  LilvNode* const  path    = lilv_new_string(world, LILV_TEST_DIR);
+  LilvNode* const  threads = lilv_new_int(world, (int)n_threads);
+
+  lilv_world_set_option(world, LILV_OPTION_LV2_PATH, path);
+  lilv_world_set_option(world, LILV_OPTION_DISCOVERY_THREADS, threads);
+  lilv_world_load_all(world);
+
+  lilv_node_free(threads);
+  lilv_node_free(path);
+  return world;
+}
+
+int
+main(void)
+{
+  LilvWorld* const serial   = load_world(1);
+  LilvWorld* const parallel = load_world(4);
+
+  const LilvPlugins* serial_plugins   = lilv_world_get_all_plugins(serial);
+  const LilvPlugins* parallel_plugins = lilv_world_get_all_plugins(parallel);
+
+  assert(lilv_plugins_size(serial_plugins) > 0);
+  assert(lilv_plugins_size(parallel_plugins) ==
+         lilv_plugins_size(serial_plugins));
+
+  // Every plugin must be loaded from the same bundle as in a serial load
+  LILV_FOREACH (plugins, i, serial_plugins) {
+    const LilvPlugin* const plug = lilv_plugins_get(serial_plugins, i);
+    const LilvPlugin* const other =
+      lilv_plugins_get_by_uri(parallel_plugins, lilv_plugin_get_uri(plug));
+
+    assert(other);
+    assert(lilv_node_equals(lilv_plugin_get_bundle_uri(plug),
+                            lilv_plugin_get_bundle_uri(other)));
+    assert(lilv_plugin_is_replaced(plug) == lilv_plugin_is_replaced(other));
+  }
+
+  // The newer version of a plugin must win regardless of discovery order
+  LilvNode* const versioned =
+    lilv_new_uri(parallel, "http://example.org/versioned");
+
+  const LilvPlugin* const plug =
+    lilv_plugins_get_by_uri(parallel_plugins, versioned);
+
+  assert(plug);
+
+  LilvNode* const minor =
+    lilv_new_uri(parallel, "http://lv2plug.in/ns/lv2core#minorVersion");
+  LilvNodes* const values = lilv_plugin_get_value(plug, minor);
+  assert(values);
+  assert(lilv_node_as_int(lilv_nodes_get_first(values)) == 2);
+
+  lilv_nodes_free(values);
+  lilv_node_free(minor);
+  lilv_node_free(versioned);
+
+  // Load all plugin data in parallel up front
+  LilvNode* const plugin_uri =
+    lilv_new_uri(parallel, "http://example.org/lilv-test-plugin");
+  LilvNode* const name_pred =
+    lilv_new_uri(parallel, "http://usefulinc.com/ns/doap#name");
+
+  assert(!lilv_world_ask(parallel, plugin_uri, name_pred, NULL));
+  lilv_world_load_all_plugin_data(parallel);
+  assert(lilv_world_ask(parallel, plugin_uri, name_pred, NULL));
+
+  // Every plugin must have the same data as one loaded lazily
+  LILV_FOREACH (plugins, i, serial_plugins) {
+    const LilvPlugin* const plug = lilv_plugins_get(serial_plugins, i);
+    const LilvPlugin* const other =
+      lilv_plugins_get_by_uri(parallel_plugins, lilv_plugin_get_uri(plug));
+
+    LilvNode* const name       = lilv_plugin_get_name(plug);
+    LilvNode* const other_name = lilv_plugin_get_name(other);
+
+    assert(lilv_node_equals(name, other_name));
+    assert(lilv_plugin_get_num_ports(plug) ==
+           lilv_plugin_get_num_ports(other));
+
+    lilv_node_free(other_name);
+    lilv_node_free(name);
+  }
+
+  lilv_node_free(name_pred);
+  lilv_node_free(plugin_uri);
+
+  lilv_world_free(parallel);
+  lilv_world_free(serial);
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "zix/thread.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define N_THREADS 4U
+#define N_ROUNDS 16U
+
+/** Query everything about every plugin and return a count of the results. */
+static size_t
+query_plugins(LilvWorld* world)
+{
+  const LilvPlugins* const plugins = lilv_world_get_all_plugins(world);
+  size_t                   count   = 0U;
+
+  LILV_FOREACH (plugins, i, plugins) {
+    const LilvPlugin* const plug = lilv_plugins_get(plugins, i);
+    LilvNode* const         label = lilv_plugin_get_name(plug);
+
+    count += label != NULL;
+    count += lilv_plugin_get_class(plug) != NULL;
+    count += lilv_plugin_get_library_uri(plug) != NULL;
+
+    for (uint32_t p = 0U; p < lilv_plugin_get_num_ports(plug); ++p) {
+      const LilvPort* const port = lilv_plugin_get_port_by_index(plug, p);
+      LilvNode* const       name = lilv_port_get_name(plug, port);
+
+      count += name != NULL;
+      count += lilv_port_get_symbol(plug, port) != NULL;
+      lilv_node_free(name);
+    }
+
+    LilvNodes* const features = lilv_plugin_get_supported_features(plug);
+    count += lilv_nodes_size(features);
+    lilv_nodes_free(features);
+
+    lilv_node_free(label);
+  }
+
+  return count;
+}
+
+static void*
+query_thread(void* data)
+{
+  LilvWorld* const world    = (LilvWorld*)data;
+  const size_t     expected = query_plugins(world);
+
+  for (unsigned r = 0U; r < N_ROUNDS; ++r) {
+    assert(query_plugins(world) == expected);
+  }
+
+  return NULL;
+}
+
+int
+main(void)
+{
+  LilvWorld* const world = lilv_world_new();
+  LilvNode* const  path  = lilv_new_string(world, LILV_TEST_DIR);
+
+  lilv_world_set_option(world, LILV_OPTION_LV2_PATH, path);
+  lilv_node_free(path);
+  lilv_world_load_all(world);
+  lilv_world_freeze(world);
+
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) > 0);
+
+  const size_t expected = query_plugins(world);
+  assert(expected > 0);
+
+  // Query the frozen world from several threads at once
+  ZixThread threads[N_THREADS];
+  for (unsigned t = 0U; t < N_THREADS; ++t) {
+    assert(!zix_thread_create(&threads[t], 0, query_thread, world));
+  }
+
+  for (unsigned t = 0U; t < N_THREADS; ++t) {
+    assert(!zix_thread_join(threads[t], NULL));
+  }
+
+  // The results are the same as a single-threaded query
+  assert(query_plugins(world) == expected);
+
+  lilv_world_free(world);
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_uri_map.h"
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+
+#include "lilv/lilv.h"
+#include "lv2/core/lv2.h"
+#include "lv2/urid/urid.h"
+#include "serd/serd.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TEST_PLUGIN_URI "http://example.org/lilv-test-plugin"
+
+#define N_NODES 3U
+
+static const LilvPlugin*
+load_test_plugin(LilvWorld* world)
+{
+  uint8_t*  abs_bundle = (uint8_t*)lilv_path_absolute(LILV_TEST_BUNDLE);
+  SerdNode  bundle     = serd_node_new_file_uri(abs_bundle, 0, 0, true);
+  LilvNode* bundle_uri = lilv_new_uri(world, (const char*)bundle.buf);
+  LilvNode* plugin_uri = lilv_new_uri(world, TEST_PLUGIN_URI);
+
+  lilv_world_load_bundle(world, bundle_uri);
+
+  const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+  const LilvPlugin*  plugin  = lilv_plugins_get_by_uri(plugins, plugin_uri);
+
+  lilv_node_free(plugin_uri);
+  lilv_node_free(bundle_uri);
+  serd_node_free(&bundle);
+  free(abs_bundle);
+
+  assert(plugin);
+  return plugin;
+}
+
+int
+main(void)
+{
+  LilvTestEnv* const env = lilv_test_env_new();
+  LilvTestUriMap     uri_map;
+  lilv_test_uri_map_init(&uri_map);
+
+  LV2_URID_Map       map         = {&uri_map, map_uri};
+  const LV2_Feature  map_feature = {LV2_URID_MAP_URI, &map};
+  const LV2_Feature* features[]  = {&map_feature, NULL};
+
+  const LilvPlugin* const plugin = load_test_plugin(env->world);
+
+  LilvInstance* instances[N_NODES];
+  LilvGraph*    graph = lilv_graph_new(64U, 1024U, &map, 2U);
+  for (unsigned i = 0U; i < N_NODES; ++i) {
+    instances[i] = lilv_plugin_instantiate(plugin, 48000.0, features);
+    assert(instances[i]);
+    assert(!lilv_graph_add(graph, plugin, instances[i]));
+    lilv_instance_activate(instances[i]);
+  }
+
+  // Fan out from the output of the first node (ports are in, out, control)
+  assert(!lilv_graph_connect(graph, 0U, 1U, 1U, 0U));
+  assert(!lilv_graph_connect(graph, 0U, 1U, 2U, 0U));
+
+  // Invalid connections
+  assert(lilv_graph_connect(graph, 0U, 1U, 1U, 0U)); // Already connected
+  assert(lilv_graph_connect(graph, 1U, 0U, 2U, 2U)); // From an input
+  assert(lilv_graph_connect(graph, 1U, 1U, 2U, 1U)); // To an output
+  assert(lilv_graph_connect(graph, 1U, 1U, 2U, 3U)); // Nonexistent port
+  assert(lilv_graph_connect(graph, 1U, 1U, 3U, 0U)); // Nonexistent node
+
+  assert(!lilv_graph_get_order(graph));
+  assert(!lilv_graph_compile(graph));
+
+  // The first node runs first, then the others which only depend on it
+  const uint32_t* const order = lilv_graph_get_order(graph);
+  assert(order);
+  assert(order[0] == 0U);
+  assert((order[1] == 1U && order[2] == 2U) ||
+         (order[1] == 2U && order[2] == 1U));
+
+  // Connected ports share an aligned buffer
+  float* const out = (float*)lilv_graph_get_buffer(graph, 0U, 1U);
+  assert(out);
+  assert(!((uintptr_t)out % 64U));
+  assert(lilv_graph_get_buffer(graph, 1U, 0U) == out);
+  assert(lilv_graph_get_buffer(graph, 2U, 0U) == out);
+  assert(!lilv_graph_get_buffer(graph, 3U, 0U));
+
+  // The test plugin copies its input to the last of ports 1 and 2 connected
+  float* const in      = (float*)lilv_graph_get_buffer(graph, 0U, 0U);
+  float* const control = (float*)lilv_graph_get_buffer(graph, 0U, 2U);
+  *in                  = 0.5f;
+  *control             = 0.0f;
+  lilv_graph_run(graph, 1U);
+  assert(*control == 0.5f);
+
+  // A cycle can not be compiled
+  assert(!lilv_graph_connect(graph, 1U, 1U, 0U, 0U));
+  assert(lilv_graph_compile(graph));
+  assert(!lilv_graph_get_order(graph));
+
+  lilv_graph_free(graph);
+  for (unsigned i = 0U; i < N_NODES; ++i) {
+    lilv_instance_deactivate(instances[i]);
+    lilv_instance_free(instances[i]);
+  }
+
+  lilv_test_uri_map_clear(&uri_map);
+  lilv_test_env_free(env);
+
+  return 0;
+}
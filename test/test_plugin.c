@@ -192,6 +192,22 @@ main(void)
   assert(lilv_plugin_has_feature(plug, event_feature));
   assert(!lilv_plugin_has_feature(plug, pretend_feature));
 
+  const LV2_Feature  event_data = {"http://lv2plug.in/ns/ext/event", NULL};
+  const LV2_Feature* features[] = {&event_data, NULL};
+
+  LilvFeatureSet* const host_features = lilv_feature_set_new(world, NULL);
+  assert(!lilv_plugin_is_supported(plug, host_features));
+  lilv_feature_set_add(host_features, rt_feature);
+  assert(lilv_feature_set_contains(host_features, rt_feature));
+  assert(!lilv_feature_set_contains(host_features, event_feature));
+  assert(!lilv_plugin_is_supported(plug, host_features));
+  lilv_feature_set_free(host_features);
+
+  LilvFeatureSet* const all_features = lilv_feature_set_new(world, features);
+  assert(lilv_feature_set_contains(all_features, event_feature));
+  assert(lilv_plugin_is_supported(plug, all_features));
+  lilv_feature_set_free(all_features);
+
   lilv_node_free(rt_feature);
   lilv_node_free(event_feature);
   lilv_node_free(pretend_feature);
@@ -21,6 +21,7 @@
 #include "lilv/lilv.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -72,6 +73,13 @@ static const char* const plugin_ttl = "\
 		lv2:index 3 ;\n\
 		lv2:symbol \"audio_out\" ;\n\
 		lv2:name \"Audio Output\" ;\n\
+	] , [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:OutputPort ;\n\
+		lv2:index 4 ;\n\
+		lv2:symbol \"latency\" ;\n\
+		lv2:name \"Latency\" ;\n\
+		lv2:designation <http://example.org/other> , lv2:latency\n\
 	] .\n";
 
 int
@@ -120,7 +128,7 @@ main(void)
     lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#OutputPort");
 
   assert(lilv_nodes_size(lilv_port_get_classes(plug, p)) == 2);
-  assert(lilv_plugin_get_num_ports(plug) == 4);
+  assert(lilv_plugin_get_num_ports(plug) == 5);
   assert(lilv_port_is_a(plug, p, control_class));
   assert(lilv_port_is_a(plug, p, in_class));
   assert(!lilv_port_is_a(plug, p, audio_class));
@@ -302,6 +310,28 @@ main(void)
   assert(lilv_plugin_get_num_ports_of_class(
            plug, audio_class, out_class, NULL) == 1);
 
+  const LilvPortTable* const table = lilv_plugin_get_port_table(plug);
+  assert(table);
+  assert(table->n_ports == 5);
+  assert(table == lilv_plugin_get_port_table(plug));
+  assert(!strcmp(lilv_node_as_string(table->symbols[0]), "foo"));
+  assert(!strcmp(lilv_node_as_string(table->symbols[3]), "audio_out"));
+  assert(table->classes[0] ==
+         (LILV_PORT_CLASS_INPUT | LILV_PORT_CLASS_CONTROL));
+  assert(table->classes[2] == (LILV_PORT_CLASS_INPUT | LILV_PORT_CLASS_AUDIO));
+  assert(table->classes[3] == (LILV_PORT_CLASS_OUTPUT | LILV_PORT_CLASS_AUDIO));
+  assert(table->properties[0] == LILV_PORT_PROP_INTEGER);
+  assert(!table->properties[3]);
+  assert(table->defaults[0] == 0.5f);
+  assert(table->minimums[0] == -1.0f);
+  assert(table->maximums[0] == 1.0f);
+  assert(isnan(table->defaults[2]));
+  assert(!table->designations[0]);
+
+  // The latency port has another designation, so may not be first
+  assert(lilv_plugin_has_latency(plug));
+  assert(lilv_plugin_get_latency_port_index(plug) == 4);
+
   lilv_nodes_free(names);
   lilv_node_free(name_p);
 
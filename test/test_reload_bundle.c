@@ -37,7 +37,9 @@ main(void)
                 ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT
                 "> ; rdfs:seeAlso <plugin.ttl> .\n",
                 ":plug a lv2:Plugin ; "
-                "doap:name \"First name\" .");
+                "doap:name \"First name\" ; "
+                "lv2:port [ a lv2:InputPort , lv2:ControlPort ; "
+                "lv2:index 0 ; lv2:symbol \"gain\" ; lv2:name \"Gain\" ] .");
 
   lilv_world_load_specifications(world);
 
@@ -54,6 +56,12 @@ main(void)
   assert(!strcmp(lilv_node_as_string(name), "First name"));
   lilv_node_free(name);
 
+  // Check that port is present
+  const LilvPort* port = lilv_plugin_get_port_by_index(plug, 0);
+  assert(port);
+  assert(!strcmp(lilv_node_as_string(lilv_port_get_symbol(plug, port)),
+                 "gain"));
+
   // Unload bundle from world and delete it
   lilv_world_unload_bundle(world, env->test_bundle_uri);
   delete_bundle(env);
@@ -64,7 +72,10 @@ main(void)
                 ":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT
                 "> ; rdfs:seeAlso <plugin.ttl> .\n",
                 ":plug a lv2:Plugin ; "
-                "doap:name \"Second name\" .");
+                "doap:name \"Second name\" ; "
+                "<http://purl.org/dc/terms/replaces> :old ; "
+                "lv2:port [ a lv2:InputPort , lv2:ControlPort ; "
+                "lv2:index 0 ; lv2:symbol \"level\" ; lv2:name \"Level\" ] .");
 
   // Check that plugin is no longer in the world's plugin list
   assert(lilv_plugins_size(plugins) == 0);
@@ -83,6 +94,17 @@ main(void)
   assert(!strcmp(lilv_node_as_string(name2), "Second name"));
   lilv_node_free(name2);
 
+  // Check that the replacement described in the plugin data is indexed
+  LilvNode* const old_uri = lilv_new_uri(world, "http://example.org/old");
+  assert(lilv_world_get_replacement(world, old_uri) == plug2);
+  lilv_node_free(old_uri);
+
+  // Check that the port is reused and has the new symbol
+  const LilvPort* port2 = lilv_plugin_get_port_by_index(plug2, 0);
+  assert(port2 == port);
+  assert(!strcmp(lilv_node_as_string(lilv_port_get_symbol(plug2, port)),
+                 "level"));
+
   // Load new bundle again (noop)
   lilv_world_load_bundle(world, env->test_bundle_uri);
 
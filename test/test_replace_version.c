@@ -93,6 +93,32 @@ main(void)
 
   lilv_node_free(new_bundle);
   lilv_node_free(old_bundle);
+
+  // Load the new version first, with its data only in its resource graph
+  LilvWorld* const res_world = lilv_world_new();
+  LilvNode* const  res_plug_uri =
+    lilv_new_uri(res_world, lilv_node_as_uri(plug_uri));
+  LilvNode* const res_new_bundle =
+    lilv_new_file_uri(res_world, NULL, new_bundle_path);
+  LilvNode* const res_old_bundle =
+    lilv_new_file_uri(res_world, NULL, old_bundle_path);
+
+  lilv_world_load_bundle(res_world, res_new_bundle);
+  lilv_world_load_resource(res_world, res_plug_uri);
+
+  // Check that the old version is ignored, since the version is found there
+  lilv_world_load_bundle(res_world, res_old_bundle);
+  plugins  = lilv_world_get_all_plugins(res_world);
+  new_plug = lilv_plugins_get_by_uri(plugins, res_plug_uri);
+  assert(new_plug);
+  assert(
+    lilv_node_equals(lilv_plugin_get_bundle_uri(new_plug), res_new_bundle));
+
+  lilv_node_free(res_old_bundle);
+  lilv_node_free(res_new_bundle);
+  lilv_node_free(res_plug_uri);
+  lilv_world_free(res_world);
+
   free(new_bundle_path);
   free(old_bundle_path);
   lilv_node_free(plug_uri);
@@ -0,0 +1,189 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PREFIXES                                     \
+  MANIFEST_PREFIXES                                  \
+  "@prefix dcterms: <http://purl.org/dc/terms/> .\n" \
+  "@prefix doap: <http://usefulinc.com/ns/doap#> .\n"
+
+static void
+write_bundle(const char* lv2_dir, const char* name, const char* ttl)
+{
+  char* const bundle_path   = lilv_path_join(lv2_dir, name);
+  char* const manifest_path = lilv_path_join(bundle_path, "manifest.ttl");
+
+  lilv_create_directories(bundle_path);
+
+  FILE* const manifest = fopen(manifest_path, "w");
+  assert(manifest);
+  fprintf(manifest, "%s%s", PREFIXES, ttl);
+  fclose(manifest);
+
+  free(manifest_path);
+  free(bundle_path);
+}
+
+static void
+remove_bundle(const char* lv2_dir, const char* name)
+{
+  char* const bundle_path   = lilv_path_join(lv2_dir, name);
+  char* const manifest_path = lilv_path_join(bundle_path, "manifest.ttl");
+
+  lilv_remove(manifest_path);
+  lilv_remove(bundle_path);
+
+  free(manifest_path);
+  free(bundle_path);
+}
+
+static const LilvPlugin*
+get_plugin(LilvWorld* world, const char* uri)
+{
+  LilvNode* const         node = lilv_new_uri(world, uri);
+  const LilvPlugin* const plug =
+    lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world), node);
+
+  lilv_node_free(node);
+  return plug;
+}
+
+static bool
+plugin_name_equals(const LilvPlugin* plug, const char* expected)
+{
+  LilvNode* const name   = lilv_plugin_get_name(plug);
+  const bool      equals = !strcmp(lilv_node_as_string(name), expected);
+
+  lilv_node_free(name);
+  return equals;
+}
+
+int
+main(void)
+{
+  char* const lv2_dir = lilv_create_temporary_directory("lilvXXXXXX");
+
+  write_bundle(lv2_dir,
+               "a.lv2",
+               ":a a lv2:Plugin , :Thing ; lv2:binary <a" SHLIB_EXT "> ;"
+               " doap:name \"A\" .\n"
+               ":Thing a rdfs:Class ; rdfs:subClassOf lv2:Plugin ;"
+               " rdfs:label \"Thing\" .\n");
+
+  LilvWorld* const world = lilv_world_new();
+  LilvNode* const  path  = lilv_new_string(world, lv2_dir);
+  lilv_world_set_option(world, LILV_OPTION_LV2_PATH, path);
+  lilv_node_free(path);
+
+  lilv_world_load_all(world);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 1);
+
+  // Plugin classes are loaded when they are first needed
+  const LilvPluginClass* const thing =
+    lilv_plugin_get_class(get_plugin(world, "http://example.org/a"));
+  assert(!strcmp(lilv_node_as_string(lilv_plugin_class_get_label(thing)),
+                 "Thing"));
+  assert(lilv_plugin_classes_size(lilv_world_get_plugin_classes(world)) == 1);
+
+  // Nothing has changed
+  assert(lilv_world_rescan(world) == 0);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 1);
+
+  // Add a new bundle
+  write_bundle(lv2_dir,
+               "b.lv2",
+               ":b a lv2:Plugin ; lv2:binary <b" SHLIB_EXT "> ;"
+               " doap:name \"B\" .\n");
+
+  assert(lilv_world_rescan(world) == 1);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 2);
+  assert(plugin_name_equals(get_plugin(world, "http://example.org/b"), "B"));
+
+  // Change the new bundle (size changes in case the mtime does not)
+  write_bundle(lv2_dir,
+               "b.lv2",
+               ":b a lv2:Plugin ; lv2:binary <b" SHLIB_EXT "> ;"
+               " doap:name \"Better B\" .\n");
+
+  assert(lilv_world_rescan(world) == 1);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 2);
+
+  const LilvPlugin* const b = get_plugin(world, "http://example.org/b");
+  assert(plugin_name_equals(b, "Better B"));
+  assert(lilv_world_rescan(world) == 0);
+
+  // Remove the new bundle, the plugin should remain valid but unlisted
+  remove_bundle(lv2_dir, "b.lv2");
+  assert(lilv_world_rescan(world) == 1);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 1);
+  assert(get_plugin(world, "http://example.org/a"));
+  assert(!get_plugin(world, "http://example.org/b"));
+  assert(!strcmp(lilv_node_as_uri(lilv_plugin_get_uri(b)),
+                 "http://example.org/b"));
+
+  // Add the bundle back, which reloads its files and revives the plugin
+  write_bundle(lv2_dir,
+               "b.lv2",
+               ":b a lv2:Plugin ; lv2:binary <b" SHLIB_EXT "> ;"
+               " doap:name \"B again\" ; dcterms:replaces :a , :gone .\n");
+
+  assert(lilv_world_rescan(world) == 1);
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 2);
+  assert(get_plugin(world, "http://example.org/b") == b);
+  assert(plugin_name_equals(b, "B again"));
+
+  // The new version of B replaces A and a plugin that is not installed
+  LilvNode* const a_uri    = lilv_new_uri(world, "http://example.org/a");
+  LilvNode* const gone_uri = lilv_new_uri(world, "http://example.org/gone");
+  assert(lilv_plugin_is_replaced(get_plugin(world, "http://example.org/a")));
+  assert(!lilv_plugin_is_replaced(b));
+  assert(lilv_world_get_replacement(world, a_uri) == b);
+  assert(lilv_world_get_replacement(world, gone_uri) == b);
+  assert(!lilv_world_get_replacement(world, lilv_plugin_get_uri(b)));
+
+  // Unload it explicitly, which only touches that bundle
+  LilvNode* const b_bundle = lilv_node_duplicate(lilv_plugin_get_bundle_uri(b));
+  assert(!lilv_world_unload_bundle(world, b_bundle));
+  assert(lilv_plugins_size(lilv_world_get_all_plugins(world)) == 1);
+  assert(get_plugin(world, "http://example.org/a"));
+  assert(!get_plugin(world, "http://example.org/b"));
+  assert(!lilv_world_get_replacement(world, a_uri));
+  lilv_node_free(gone_uri);
+  lilv_node_free(a_uri);
+  lilv_node_free(b_bundle);
+
+  lilv_world_free(world);
+
+  remove_bundle(lv2_dir, "b.lv2");
+  remove_bundle(lv2_dir, "a.lv2");
+  lilv_remove(lv2_dir);
+  free(lv2_dir);
+
+  return 0;
+}
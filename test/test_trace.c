@@ -0,0 +1,212 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	doap:name \"Test plugin\" .\n";
+
+static const char*
+skip_space(const char* s)
+{
+  while (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r') {
+    ++s;
+  }
+
+  return s;
+}
+
+static const char*
+parse_value(const char* s);
+
+static const char*
+parse_string(const char* s)
+{
+  if (*s != '"') {
+    return NULL;
+  }
+
+  for (++s; *s != '"'; ++s) {
+    if ((unsigned char)*s < 0x20) {
+      return NULL;
+    }
+
+    if (*s == '\\' && !*++s) {
+      return NULL;
+    }
+  }
+
+  return s + 1;
+}
+
+static const char*
+parse_number(const char* s)
+{
+  const char* const start = s;
+  while ((*s >= '0' && *s <= '9') || *s == '-' || *s == '.' || *s == 'e' ||
+         *s == 'E' || *s == '+') {
+    ++s;
+  }
+
+  return s > start ? s : NULL;
+}
+
+/** Parse a comma-separated list of values or members, ending with `close`. */
+static const char*
+parse_list(const char* s, const char close, const bool members)
+{
+  s = skip_space(s + 1);
+  if (*s == close) {
+    return s + 1;
+  }
+
+  for (;;) {
+    if (members) {
+      if (!(s = parse_string(skip_space(s)))) {
+        return NULL;
+      }
+
+      if (*(s = skip_space(s)) != ':') {
+        return NULL;
+      }
+
+      ++s;
+    }
+
+    if (!(s = parse_value(s))) {
+      return NULL;
+    }
+
+    if (*(s = skip_space(s)) == close) {
+      return s + 1;
+    }
+
+    if (*s != ',') {
+      return NULL;
+    }
+
+    ++s;
+  }
+}
+
+/** Return the end of the JSON value at the start of `s`, or NULL. */
+static const char*
+parse_value(const char* s)
+{
+  s = skip_space(s);
+  switch (*s) {
+  case '{':
+    return parse_list(s, '}', true);
+  case '[':
+    return parse_list(s, ']', false);
+  case '"':
+    return parse_string(s);
+  case 't':
+    return strncmp(s, "true", 4) ? NULL : s + 4;
+  case 'f':
+    return strncmp(s, "false", 5) ? NULL : s + 5;
+  case 'n':
+    return strncmp(s, "null", 4) ? NULL : s + 4;
+  default:
+    break;
+  }
+
+  return parse_number(s);
+}
+
+static char*
+read_trace(const char* path)
+{
+  FILE* const file = fopen(path, "rb");
+  assert(file);
+
+  fseek(file, 0, SEEK_END);
+  const long len = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  assert(len > 0);
+
+  char* const  text   = (char*)calloc(1, (size_t)len + 1U);
+  const size_t n_read = fread(text, 1, (size_t)len, file);
+  assert(n_read == (size_t)len);
+  fclose(file);
+
+  return text;
+}
+
+int
+main(void)
+{
+  char* const trace_dir  = lilv_create_temporary_directory("lilvXXXXXX");
+  char* const trace_path = lilv_path_join(trace_dir, "trace.json");
+
+  LilvTestEnv* const env   = lilv_test_env_new();
+  LilvWorld* const   world = env->world;
+
+  LilvNode* const trace_file = lilv_new_string(world, trace_path);
+  lilv_world_set_option(world, LILV_OPTION_TRACE_FILE, trace_file);
+  lilv_node_free(trace_file);
+
+  if (create_bundle(env, "trace.lv2", SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+    return 1;
+  }
+
+  // Load the bundle and the plugin's data
+  lilv_world_load_bundle(world, env->test_bundle_uri);
+
+  const LilvPlugins* const plugins = lilv_world_get_all_plugins(world);
+  const LilvPlugin* const  plug =
+    lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+  assert(plug);
+
+  LilvNode* const name = lilv_plugin_get_name(plug);
+  assert(!strcmp(lilv_node_as_string(name), "Test plugin"));
+  lilv_node_free(name);
+
+  // Free the world, which finishes the trace
+  delete_bundle(env);
+  lilv_test_env_free(env);
+
+  // Check that the trace is a complete JSON array with the expected events
+  char* const       text = read_trace(trace_path);
+  const char* const end  = parse_value(text);
+  assert(end);
+  assert(!*skip_space(end));
+  assert(*skip_space(text) == '[');
+  assert(strstr(text, "\"name\":\"lilv_world_load_bundle\""));
+  assert(strstr(text, "\"name\":\"lilv_plugin_load\""));
+  assert(strstr(text, "\"tid\":1,"));
+  free(text);
+
+  lilv_remove(trace_path);
+  lilv_remove(trace_dir);
+  free(trace_path);
+  free(trace_dir);
+
+  return 0;
+}
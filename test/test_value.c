@@ -142,6 +142,11 @@ main(void)
   LilvNode* uval_dup = lilv_node_duplicate(uval);
   assert(lilv_node_equals(uval, uval_dup));
 
+  // Resource nodes are interned, so equal ones are the same object
+  assert(uval_e == uval);
+  assert(uval_dup == uval);
+  assert(uval_ne != uval);
+
   LilvNode* ifval = lilv_new_float(world, 42.0);
   assert(!lilv_node_equals(ival, ifval));
   lilv_node_free(ifval);
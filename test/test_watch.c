@@ -0,0 +1,106 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+#include "../src/lilv_config.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if USE_INOTIFY
+#  include <time.h>
+
+static const char* const manifest_ttl =
+  MANIFEST_PREFIXES ":plug a lv2:Plugin ; lv2:binary <plug" SHLIB_EXT "> .\n";
+
+static size_t
+num_plugins(LilvWorld* world)
+{
+  return lilv_plugins_size(lilv_world_get_all_plugins(world));
+}
+
+/** Process changes until the number of plugins is `n`, or time out. */
+static void
+wait_for_plugins(LilvWorld* world, const size_t n)
+{
+  const struct timespec delay = {0, 50000000L};
+
+  for (unsigned i = 0U; i < 100U && num_plugins(world) != n; ++i) {
+    nanosleep(&delay, NULL);
+    lilv_world_process_changes(world);
+  }
+
+  assert(num_plugins(world) == n);
+}
+
+int
+main(void)
+{
+  char* const lv2_dir       = lilv_create_temporary_directory("lilvXXXXXX");
+  char* const bundle_dir    = lilv_path_join(lv2_dir, "watch.lv2");
+  char* const manifest_path = lilv_path_join(bundle_dir, "manifest.ttl");
+
+  LilvWorld* const world = lilv_world_new();
+  LilvNode* const  path  = lilv_new_string(world, lv2_dir);
+  lilv_world_set_option(world, LILV_OPTION_LV2_PATH, path);
+  lilv_node_free(path);
+
+  lilv_world_load_all(world);
+  assert(num_plugins(world) == 0);
+  assert(lilv_world_watch(world) >= 0);
+  assert(lilv_world_process_changes(world) == 0);
+
+  // Install a bundle
+  lilv_create_directories(bundle_dir);
+  FILE* const manifest = fopen(manifest_path, "w");
+  assert(manifest);
+  fprintf(manifest, "%s", manifest_ttl);
+  fclose(manifest);
+
+  wait_for_plugins(world, 1);
+
+  // Remove the bundle
+  lilv_remove(manifest_path);
+  lilv_remove(bundle_dir);
+
+  wait_for_plugins(world, 0);
+
+  lilv_world_free(world);
+
+  lilv_remove(lv2_dir);
+  free(manifest_path);
+  free(bundle_dir);
+  free(lv2_dir);
+
+  return 0;
+}
+
+#else
+
+int
+main(void)
+{
+  return 0;
+}
+
+#endif